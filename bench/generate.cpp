@@ -0,0 +1,88 @@
+#include "generator.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Writes a synthetic budget to stdout, or to the file given with --output:
+//
+//   sbash64-budget-generate --transactions 50000000 --seed 7 > budget.txt
+namespace sbash64::budget {
+namespace {
+class OutputStreamFactory : public IoStreamFactory {
+public:
+  explicit OutputStreamFactory(std::string path) : path{std::move(path)} {}
+
+  auto makeInput() -> std::shared_ptr<std::istream> override { return {}; }
+
+  auto makeOutput() -> std::shared_ptr<std::ostream> override {
+    if (path.empty())
+      return {&std::cout, [](std::ostream *) {}};
+    return std::make_shared<std::ofstream>(path);
+  }
+
+private:
+  std::string path;
+};
+
+void usage() {
+  std::cerr << "usage: sbash64-budget-generate [--seed n] [--accounts n] "
+               "[--transactions n]\n"
+               "    [--first-year n] [--days n] [--vocabulary n] [--skew x]\n"
+               "    [--verified fraction] [--archived fraction] "
+               "[--output path]\n";
+}
+
+auto run(int argc, char *argv[]) -> int {
+  GeneratorOptions options;
+  std::string output;
+  for (auto i{1}; i < argc; i += 2) {
+    if (i + 1 == argc) {
+      usage();
+      return EXIT_FAILURE;
+    }
+    const std::string_view name{argv[i]};
+    const std::string value{argv[i + 1]};
+    if (name == "--seed")
+      options.seed = std::stoull(value);
+    else if (name == "--accounts")
+      options.accounts = std::stoi(value);
+    else if (name == "--transactions")
+      options.transactions = std::stoll(value);
+    else if (name == "--first-year")
+      options.firstYear = std::stoi(value);
+    else if (name == "--days")
+      options.days = std::stoi(value);
+    else if (name == "--vocabulary")
+      options.vocabulary = std::stoi(value);
+    else if (name == "--skew")
+      options.skew = std::stod(value);
+    else if (name == "--verified")
+      options.verified = std::stod(value);
+    else if (name == "--archived")
+      options.archived = std::stod(value);
+    else if (name == "--output")
+      output = value;
+    else {
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+  if (options.accounts < 1 || options.days < 1 || options.vocabulary < 1 ||
+      options.transactions < 0) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  std::ios::sync_with_stdio(false);
+  OutputStreamFactory streams{output};
+  generate(streams, options);
+  return std::cout ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace
+} // namespace sbash64::budget
+
+int main(int argc, char *argv[]) { return sbash64::budget::run(argc, argv); }
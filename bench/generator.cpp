@@ -0,0 +1,185 @@
+#include "generator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sbash64::budget {
+namespace {
+constexpr std::array<std::string_view, 12> accountNames{
+    "Clothing", "Dining",  "Entertainment", "Gas",       "Gifts",
+    "Groceries", "Insurance", "Medical",   "Phone",     "Rent",
+    "Travel",   "Utilities"};
+
+constexpr std::array<std::string_view, 16> syllables{
+    "ba", "ko", "ri", "ne", "su", "ta", "mi", "lo",
+    "ve", "du", "ga", "pe", "zo", "hu", "fi", "ja"};
+
+// Only the engine's own output is used: the standard distributions may differ
+// between library implementations, which would change the file.
+class Random {
+public:
+  explicit Random(std::uint_least64_t seed) : engine{seed} {}
+
+  auto below(std::uint_least64_t n) -> std::uint_least64_t {
+    return engine() % n;
+  }
+
+  // In [0, 1).
+  auto unit() -> double {
+    return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+  }
+
+private:
+  std::mt19937_64 engine;
+};
+
+// Spells rank k with the digits of k + 1 in base 16, so that the frequent
+// words are the short ones.
+auto word(std::size_t rank) -> std::string {
+  std::string spelled;
+  for (auto n{rank + 1}; n != 0; n /= syllables.size())
+    spelled.insert(0, syllables.at(n % syllables.size()));
+  return spelled;
+}
+
+auto accountName(int index) -> std::string {
+  if (index < static_cast<int>(accountNames.size()))
+    return std::string{accountNames.at(index)};
+  return "Account " + std::to_string(index + 1);
+}
+
+class Generator {
+public:
+  explicit Generator(const GeneratorOptions &options)
+      : options{options}, random{options.seed},
+        first{std::chrono::year{options.firstYear} / std::chrono::January /
+              1} {
+    double sum{0};
+    for (auto rank{0}; rank < options.vocabulary; ++rank) {
+      sum += 1 / std::pow(rank + 1, options.skew);
+      cumulativeWeights.push_back(sum);
+      words.push_back(word(rank));
+    }
+  }
+
+  auto expense() -> ArchivableVerifiableTransaction {
+    const auto scale{static_cast<std::int_least64_t>(random.below(1000))};
+    return withStatus(
+        {USD{99 + scale * scale / 20}, description(),
+         date(static_cast<int>(
+             random.below(static_cast<std::uint_least64_t>(options.days))))});
+  }
+
+  auto paycheck(int index) -> ArchivableVerifiableTransaction {
+    return withStatus({USD{250000}, "paycheck", date(index * 14)});
+  }
+
+  auto allocation() -> USD {
+    return USD{static_cast<std::int_least64_t>(random.below(100000))};
+  }
+
+private:
+  auto withStatus(Transaction transaction) -> ArchivableVerifiableTransaction {
+    ArchivableVerifiableTransaction generated{std::move(transaction)};
+    const auto status{random.unit()};
+    generated.archived = status < options.archived;
+    generated.verified =
+        !generated.archived && status < options.archived + options.verified;
+    return generated;
+  }
+
+  auto description() -> const std::string & {
+    const auto target{random.unit() * cumulativeWeights.back()};
+    const auto rank{std::upper_bound(cumulativeWeights.begin(),
+                                     cumulativeWeights.end(), target) -
+                    cumulativeWeights.begin()};
+    return words.at(std::min<std::size_t>(rank, words.size() - 1));
+  }
+
+  auto date(int daysAfterFirst) const -> Date {
+    const std::chrono::year_month_day day{
+        std::chrono::sys_days{first} + std::chrono::days{daysAfterFirst}};
+    return Date{static_cast<int>(day.year()),
+                Month{static_cast<int>(static_cast<unsigned>(day.month()))},
+                static_cast<int>(static_cast<unsigned>(day.day()))};
+  }
+
+  const GeneratorOptions &options;
+  Random random;
+  std::chrono::year_month_day first;
+  std::vector<double> cumulativeWeights;
+  std::vector<std::string> words;
+};
+
+// Makes the next transaction each time it is saved, so that an account can
+// hand every slot of its list the same one.
+class GeneratedTransaction : public SerializableTransaction {
+public:
+  explicit GeneratedTransaction(
+      std::function<ArchivableVerifiableTransaction()> next)
+      : next{std::move(next)} {}
+
+  void save(TransactionSerialization &serialization) override {
+    serialization.save(next());
+  }
+
+private:
+  std::function<ArchivableVerifiableTransaction()> next;
+};
+
+class GeneratedAccount : public SerializableAccount {
+public:
+  GeneratedAccount(std::int_least64_t transactions, USD allocated,
+                   std::function<ArchivableVerifiableTransaction()> next)
+      : next{std::move(next)}, transactions{transactions},
+        allocated{allocated} {}
+
+  void save(AccountSerialization &serialization) override {
+    GeneratedTransaction transaction{next};
+    serialization.save(std::vector<SerializableTransaction *>(
+                           static_cast<std::size_t>(transactions),
+                           &transaction),
+                       allocated);
+  }
+
+  void load(AccountDeserialization &) override {}
+
+private:
+  std::function<ArchivableVerifiableTransaction()> next;
+  std::int_least64_t transactions;
+  USD allocated;
+};
+} // namespace
+
+void generate(IoStreamFactory &streams, const GeneratorOptions &options) {
+  Generator generator{options};
+  auto paychecks{0};
+  GeneratedAccount incomeAccount{options.days / 14 + 1, USD{0},
+                                 [&generator, &paychecks] {
+                                   return generator.paycheck(paychecks++);
+                                 }};
+  std::vector<std::unique_ptr<GeneratedAccount>> expenseAccounts;
+  std::vector<SerializableAccountWithName> namedExpenseAccounts;
+  for (auto i{0}; i < options.accounts; ++i) {
+    expenseAccounts.push_back(std::make_unique<GeneratedAccount>(
+        options.transactions / options.accounts +
+            (i < options.transactions % options.accounts ? 1 : 0),
+        generator.allocation(), [&generator] { return generator.expense(); }));
+    namedExpenseAccounts.push_back(
+        {expenseAccounts.back().get(), accountName(i)});
+  }
+  WritesTransactionToStream::Factory transactionFactory;
+  WritesAccountToStream::Factory accountFactory{transactionFactory};
+  WritesBudgetToStream serialization{streams, accountFactory};
+  serialization.save(&incomeAccount, namedExpenseAccounts);
+}
+} // namespace sbash64::budget
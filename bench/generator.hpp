@@ -0,0 +1,32 @@
+#ifndef SBASH64_BUDGET_BENCH_GENERATOR_HPP_
+#define SBASH64_BUDGET_BENCH_GENERATOR_HPP_
+
+#include <sbash64/budget/domain.hpp>
+#include <sbash64/budget/serialization.hpp>
+
+#include <cstdint>
+
+namespace sbash64::budget {
+struct GeneratorOptions {
+  std::uint_least64_t seed{1};
+  int accounts{12};
+  // Expense transactions, spread evenly over the accounts. The income account
+  // gets a paycheck every other week on top of these.
+  std::int_least64_t transactions{1000};
+  int firstYear{2019};
+  int days{3 * 365};
+  // Descriptions are drawn from this many words, the word of rank k with a
+  // probability proportional to 1 / k^skew.
+  int vocabulary{500};
+  double skew{1.};
+  double verified{.2};
+  double archived{.1};
+};
+
+// Writes a budget of made-up transactions with WritesBudgetToStream. The same
+// options always give the same file. Transactions are made as they are
+// written, so only a pointer per transaction of one account is held at once.
+void generate(IoStreamFactory &, const GeneratorOptions &);
+} // namespace sbash64::budget
+
+#endif
@@ -0,0 +1,311 @@
+#include "generator.hpp"
+#include "streams.hpp"
+
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/allocations.hpp>
+#include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/format.hpp>
+#include <sbash64/budget/parse.hpp>
+#include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/protocol.hpp>
+#include <sbash64/budget/serialization.hpp>
+#include <sbash64/budget/string-streams.hpp>
+#include <sbash64/budget/transaction.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Times the core library's hot paths on budgets of several sizes and writes
+// the results to stdout as JSON:
+//
+//   {"benchmarks":[{"name":"load","transactions":1000,"iterations":52,
+//                   "nanosecondsPerIteration":3843012.1,
+//                   "allocationsPerIteration":15021.0,
+//                   "bytesPerIteration":1093811.2}, ...]}
+//
+// Pass transaction counts as arguments to override the default sizes.
+namespace sbash64::budget {
+namespace {
+using namespace std::chrono_literals;
+
+// The first account generate writes.
+constexpr std::string_view expenseAccount{"Clothing"};
+
+// How long each measurement runs before it is reported.
+constexpr auto minimumTime{200ms};
+
+auto budgetFile(std::int_least64_t transactions) -> std::string {
+  GeneratorOptions options;
+  options.transactions = transactions;
+  StringStreamFactory streams;
+  generate(streams, options);
+  return std::move(streams.file);
+}
+
+// Records the IDs of the unarchived transactions of one expense account as
+// they are loaded.
+class IdRecorder : public Budget::Observer, public Account::Observer {
+public:
+  explicit IdRecorder(std::string_view accountName)
+      : accountName{accountName} {}
+
+  void notifyThatExpenseAccountHasBeenCreated(Account &account,
+                                              std::string_view name) override {
+    if (name == accountName)
+      account.attach(*this);
+  }
+
+  void notifyThatHasBeenAdded(ObservableTransaction &transaction) override {
+    added.push_back(&transaction);
+  }
+
+  [[nodiscard]] auto ids() const -> std::vector<TransactionId> {
+    return ids_;
+  }
+
+  // Keeps those not yet verified once loading is done.
+  void collect() {
+    for (auto *transaction : added)
+      if (!transaction->verified())
+        ids_.push_back(transaction->id());
+    added.clear();
+  }
+
+  void notifyThatNetIncomeHasChanged(USD) override {}
+  void notifyThatExpenseHasMoved(std::string_view, std::string_view,
+                                 TransactionId) override {}
+  void notifyThatHasBeenSaved() override {}
+  void notifyThatHasUnsavedChanges() override {}
+  void notifyThatBalanceHasChanged(USD) override {}
+  void notifyThatAllocationHasChanged(USD) override {}
+  void notifyThatWillBeRemoved() override {}
+  void notifyThatNameHasChanged(std::string_view) override {}
+
+private:
+  std::string_view accountName;
+  std::vector<ObservableTransaction *> added;
+  std::vector<TransactionId> ids_;
+};
+
+// A budget as the web server holds one: in memory with a presenter attached.
+struct Fixture {
+  explicit Fixture(std::string_view file) : streams{file} {
+    budget.attach(presenter);
+    budget.attach(recorder);
+    ReadsTransactionFromStream::Factory transactionFactory_;
+    ReadsAccountFromStream::Factory accountFactory_{transactionFactory_};
+    ReadsBudgetFromStream deserialization{streams, accountFactory_};
+    budget.load(deserialization);
+    recorder.collect();
+  }
+
+  InMemoryStreamFactory streams;
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount{transactionFactory};
+  AccountInMemory::Factory accountFactory{transactionFactory};
+  BudgetInMemory budget{incomeAccount, accountFactory};
+  BudgetPresenter presenter{incomeAccount};
+  IdRecorder recorder{expenseAccount};
+};
+
+struct Measurement {
+  std::int_least64_t iterations;
+  double nanosecondsPerIteration;
+  double allocationsPerIteration;
+  double bytesPerIteration;
+};
+
+auto perIteration(std::uint_least64_t total, std::int_least64_t iterations)
+    -> double {
+  return iterations == 0
+             ? 0.
+             : static_cast<double>(total) / static_cast<double>(iterations);
+}
+
+// Runs an operation in doubling batches until a batch takes minimumTime.
+auto measure(const std::function<void()> &operation) -> Measurement {
+  for (std::int_least64_t iterations{1};; iterations *= 2) {
+    const AllocationsSince allocations;
+    const auto start{std::chrono::steady_clock::now()};
+    for (std::int_least64_t i{0}; i < iterations; ++i)
+      operation();
+    const std::chrono::duration<double, std::nano> elapsed{
+        std::chrono::steady_clock::now() - start};
+    if (elapsed >= minimumTime)
+      return {iterations, elapsed.count() / static_cast<double>(iterations),
+              perIteration(allocations.allocations(), iterations),
+              perIteration(allocations.bytes(), iterations)};
+  }
+}
+
+// Times each run of an operation alone, after a setup that is not timed,
+// until the runs add up to minimumTime or there have been maxIterations.
+auto measureEach(const std::function<void()> &setup,
+                 const std::function<void()> &operation,
+                 std::int_least64_t maxIterations) -> Measurement {
+  std::chrono::duration<double, std::nano> elapsed{0};
+  std::uint_least64_t allocations{0};
+  std::uint_least64_t bytes{0};
+  std::int_least64_t iterations{0};
+  while (iterations < maxIterations && elapsed < minimumTime) {
+    setup();
+    const AllocationsSince since;
+    const auto start{std::chrono::steady_clock::now()};
+    operation();
+    elapsed += std::chrono::steady_clock::now() - start;
+    allocations += since.allocations();
+    bytes += since.bytes();
+    ++iterations;
+  }
+  return {iterations,
+          iterations == 0 ? 0.
+                          : elapsed.count() / static_cast<double>(iterations),
+          perIteration(allocations, iterations),
+          perIteration(bytes, iterations)};
+}
+
+class Report {
+public:
+  Report() { std::cout << R"({"benchmarks":[)"; }
+
+  ~Report() { std::cout << "]}\n"; }
+
+  Report(const Report &) = delete;
+  Report(Report &&) = delete;
+  auto operator=(const Report &) -> Report & = delete;
+  auto operator=(Report &&) -> Report & = delete;
+
+  void add(std::string_view name, Measurement measurement,
+           std::int_least64_t transactions = -1) {
+    std::cout << (first ? "" : ",") << "\n" << R"({"name":")" << name << '"';
+    if (transactions >= 0)
+      std::cout << R"(,"transactions":)" << transactions;
+    std::cout << R"(,"iterations":)" << measurement.iterations
+              << R"(,"nanosecondsPerIteration":)"
+              << measurement.nanosecondsPerIteration
+              << R"(,"allocationsPerIteration":)"
+              << measurement.allocationsPerIteration
+              << R"(,"bytesPerIteration":)" << measurement.bytesPerIteration
+              << '}' << std::flush;
+    first = false;
+  }
+
+private:
+  bool first{true};
+};
+
+void runUnsized(Report &report) {
+  std::int_least64_t sink{0};
+  report.add("usd", measure([&sink] { sink += usd("1234.56").cents; }));
+  DiscardingStream stream;
+  report.add("formatUsd", measure([&stream] { stream << USD{123456}; }));
+  report.add("formatDate", measure([&stream] {
+               stream << Date{2021, Month::November, 20};
+             }));
+  if (sink == 0)
+    std::cerr << "unexpected parse\n";
+}
+
+void runSized(Report &report, std::int_least64_t transactions) {
+  const auto file{budgetFile(transactions)};
+  std::unique_ptr<Fixture> fixture;
+  const auto reload{[&] {
+    fixture.reset();
+    fixture = std::make_unique<Fixture>(file);
+  }};
+
+  report.add("load",
+             measureEach([&] { fixture.reset(); },
+                         [&] { fixture = std::make_unique<Fixture>(file); },
+                         20),
+             transactions);
+
+  reload();
+  report.add("save",
+             measureEach(
+                 [] {},
+                 [&] {
+                   WritesTransactionToStream::Factory transactionFactory;
+                   WritesAccountToStream::Factory accountFactory{
+                       transactionFactory};
+                   WritesBudgetToStream serialization{fixture->streams,
+                                                      accountFactory};
+                   fixture->budget.save(serialization);
+                 },
+                 20),
+             transactions);
+
+  report.add("addExpense",
+             measure([&] {
+               fixture->budget.addExpense(
+                   expenseAccount,
+                   {USD{4102}, "quicktrip", Date{2021, Month::March, 2}});
+             }),
+             transactions);
+
+  reload();
+  const auto ids{fixture->recorder.ids()};
+  auto nextToVerify{ids.begin()};
+  report.add("verifyExpense",
+             measureEach([] {},
+                         [&] {
+                           fixture->budget.verifyExpense(expenseAccount,
+                                                         *nextToVerify++);
+                         },
+                         static_cast<std::int_least64_t>(ids.size())),
+             transactions);
+
+  reload();
+  auto nextToRemove{ids.begin()};
+  report.add("removeExpense",
+             measureEach([] {},
+                         [&] {
+                           fixture->budget.removeExpense(expenseAccount,
+                                                         *nextToRemove++);
+                         },
+                         static_cast<std::int_least64_t>(ids.size())),
+             transactions);
+
+  report.add("reduce",
+             measureEach(reload, [&] { fixture->budget.reduce(); }, 20),
+             transactions);
+
+  reload();
+  MessageBatch batch;
+  JsonView view{batch};
+  report.add("BudgetPresenter::add",
+             measureEach(
+                 [&] {
+                   fixture->presenter.remove(&view);
+                   batch.clear();
+                 },
+                 [&] { fixture->presenter.add(&view); }, 20),
+             transactions);
+  fixture->presenter.remove(&view);
+}
+
+auto run(int argc, char *argv[]) -> int {
+  std::vector<std::int_least64_t> sizes{1000, 100000, 1000000};
+  if (argc > 1) {
+    sizes.clear();
+    for (auto i{1}; i < argc; ++i)
+      sizes.push_back(std::stoll(argv[i]));
+  }
+  Report report;
+  runUnsized(report);
+  for (const auto size : sizes)
+    runSized(report, size);
+  return EXIT_SUCCESS;
+}
+} // namespace
+} // namespace sbash64::budget
+
+int main(int argc, char *argv[]) { return sbash64::budget::run(argc, argv); }
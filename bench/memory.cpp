@@ -0,0 +1,104 @@
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/memory.hpp>
+#include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/serialization.hpp>
+#include <sbash64/budget/transaction.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Loads a budget file as the server would and reports the approximate heap
+// bytes of each account and its presenter, largest first:
+//
+//   sbash64-budget-memory budget.txt
+//   sbash64-budget-memory --json budget.txt
+namespace sbash64::budget {
+namespace {
+class InputFileStreamFactory : public IoStreamFactory {
+public:
+  explicit InputFileStreamFactory(std::string path) : path{std::move(path)} {}
+
+  auto makeInput() -> std::shared_ptr<std::istream> override {
+    return std::make_shared<std::ifstream>(path);
+  }
+
+  auto makeOutput() -> std::shared_ptr<std::ostream> override { return {}; }
+
+private:
+  std::string path;
+};
+
+void printTable(std::vector<AccountMemoryReport> reports) {
+  std::sort(reports.begin(), reports.end(),
+            [](const AccountMemoryReport &a, const AccountMemoryReport &b) {
+              return total(a) > total(b);
+            });
+  constexpr auto nameWidth{24};
+  constexpr auto width{14};
+  std::cout << std::left << std::setw(nameWidth) << "account" << std::right
+            << std::setw(width) << "total" << std::setw(width)
+            << "transactions" << std::setw(width) << "archived"
+            << std::setw(width) << "descriptions" << std::setw(width)
+            << "observers" << std::setw(width) << "presenters" << '\n';
+  std::size_t sum{0};
+  for (const auto &report : reports) {
+    std::cout << std::left << std::setw(nameWidth) << report.name
+              << std::right << std::setw(width) << total(report)
+              << std::setw(width) << report.account.transactions
+              << std::setw(width) << report.account.archivedTransactions
+              << std::setw(width) << report.account.descriptions
+              << std::setw(width) << report.account.observers
+              << std::setw(width)
+              << report.presenter.transactions +
+                     report.presenter.descriptions
+              << '\n';
+    sum += total(report);
+  }
+  std::cout << std::left << std::setw(nameWidth) << "total" << std::right
+            << std::setw(width) << sum << '\n';
+  if (const auto allocator{allocatorMemory()})
+    std::cout << "allocator: " << allocator->inUse << " in use, "
+              << allocator->free << " free\n";
+}
+
+auto run(int argc, char *argv[]) -> int {
+  const auto json{argc == 3 && std::string_view{argv[1]} == "--json"};
+  if (argc != 2 && !json) {
+    std::cerr << "usage: sbash64-budget-memory [--json] budget\n";
+    return EXIT_FAILURE;
+  }
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount{transactionFactory};
+  AccountInMemory::Factory accountFactory{transactionFactory};
+  BudgetInMemory budget{incomeAccount, accountFactory};
+  BudgetPresenter presenter{incomeAccount};
+  budget.attach(presenter);
+  InputFileStreamFactory streams{argv[argc - 1]};
+  ReadsTransactionFromStream::Factory transactionDeserializationFactory;
+  ReadsAccountFromStream::Factory accountDeserializationFactory{
+      transactionDeserializationFactory};
+  ReadsBudgetFromStream deserialization{streams,
+                                        accountDeserializationFactory};
+  budget.load(deserialization);
+  const auto reports{memoryReport(incomeAccount, budget, presenter)};
+  if (json) {
+    std::string out;
+    writeMemoryReport(out, reports);
+    std::cout << out << '\n';
+  } else
+    printTable(reports);
+  return EXIT_SUCCESS;
+}
+} // namespace
+} // namespace sbash64::budget
+
+int main(int argc, char *argv[]) { return sbash64::budget::run(argc, argv); }
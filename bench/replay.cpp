@@ -0,0 +1,138 @@
+#include "streams.hpp"
+
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/counting-view.hpp>
+#include <sbash64/budget/metrics.hpp>
+#include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/protocol.hpp>
+#include <sbash64/budget/recording.hpp>
+#include <sbash64/budget/serialization.hpp>
+#include <sbash64/budget/transaction.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string_view>
+
+// Applies a session recorded by the server to the core library alone, with
+// no networking and no disk, and writes the timings to stdout as JSON:
+//
+//   sbash64-budget-replay budgets/2024-05-01_09:30:00.recording
+//   {"payloads":212,"recordedSeconds":1804.2,"loadNanoseconds":5120332,
+//    "totalNanoseconds":9403311,"viewCalls":2741,"methods":[
+//    {"method":"add transaction","count":96,"totalNanoseconds":271003,
+//     "p50Nanoseconds":2431,"p99Nanoseconds":10239,"maxNanoseconds":10239},
+//    ...]}
+//
+// Saves are written to a stream that discards them. The total includes
+// decoding each payload.
+namespace sbash64::budget {
+namespace {
+struct Method {
+  LatencyHistogram latencies;
+  std::chrono::nanoseconds max{};
+};
+
+auto nanoseconds(std::chrono::steady_clock::duration duration)
+    -> std::int_least64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+      .count();
+}
+
+auto run(int argc, char *argv[]) -> int {
+  if (argc != 2) {
+    std::cerr << "usage: sbash64-budget-replay recording\n";
+    return EXIT_FAILURE;
+  }
+  std::ifstream file{argv[1], std::ios::binary};
+  RecordingReader reader{file};
+  if (!reader.valid()) {
+    std::cerr << argv[1] << " is not a recording\n";
+    return EXIT_FAILURE;
+  }
+
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount{transactionFactory};
+  AccountInMemory::Factory accountFactory{transactionFactory};
+  BudgetInMemory budget{incomeAccount, accountFactory};
+  BudgetPresenter presenter{incomeAccount};
+  CountingView view;
+  budget.attach(presenter);
+  presenter.attach(&view);
+  InMemoryStreamFactory streams{reader.budget()};
+  WritesTransactionToStream::Factory transactionSerializationFactory;
+  WritesAccountToStream::Factory accountSerializationFactory{
+      transactionSerializationFactory};
+  WritesBudgetToStream serialization{streams, accountSerializationFactory};
+  ReadsTransactionFromStream::Factory transactionDeserializationFactory;
+  ReadsAccountFromStream::Factory accountDeserializationFactory{
+      transactionDeserializationFactory};
+  ReadsBudgetFromStream deserialization{streams,
+                                        accountDeserializationFactory};
+
+  const auto loadStart{std::chrono::steady_clock::now()};
+  budget.load(deserialization);
+  const auto loaded{std::chrono::steady_clock::now()};
+
+  std::array<Method, static_cast<std::size_t>(Command::Method::closeAccount) +
+                         1>
+      methods;
+  std::uint_least64_t payloads{0};
+  std::chrono::microseconds recorded{};
+  while (const auto payload{reader.next()}) {
+    const auto command{jsonCommand(payload->payload)};
+    const auto start{std::chrono::steady_clock::now()};
+    try {
+      if (command.method == Command::Method::save)
+        budget.save(serialization);
+      else
+        apply(budget, command);
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << '\n';
+    }
+    const std::chrono::nanoseconds elapsed{std::chrono::steady_clock::now() -
+                                           start};
+    auto &method{methods.at(static_cast<std::size_t>(command.method))};
+    method.latencies.record(elapsed);
+    method.max = std::max(method.max, elapsed);
+    recorded = payload->sinceStart;
+    ++payloads;
+  }
+  const auto finished{std::chrono::steady_clock::now()};
+
+  std::cout << R"({"payloads":)" << payloads << R"(,"recordedSeconds":)"
+            << std::chrono::duration<double>{recorded}.count()
+            << R"(,"loadNanoseconds":)" << nanoseconds(loaded - loadStart)
+            << R"(,"totalNanoseconds":)" << nanoseconds(finished - loaded)
+            << R"(,"viewCalls":)" << view.calls << R"(,"methods":[)";
+  auto first{true};
+  for (std::size_t i{0}; i < methods.size(); ++i) {
+    const auto &method{methods.at(i)};
+    if (method.latencies.count() == 0)
+      continue;
+    std::cout << (first ? "" : ",") << "\n"
+              << R"({"method":")"
+              << methodName(static_cast<Command::Method>(i))
+              << R"(","count":)" << method.latencies.count()
+              << R"(,"totalNanoseconds":)" << method.latencies.sum().count()
+              << R"(,"p50Nanoseconds":)"
+              << method.latencies.quantile(.5).count()
+              << R"(,"p99Nanoseconds":)"
+              << method.latencies.quantile(.99).count()
+              << R"(,"maxNanoseconds":)" << method.max.count() << '}';
+    first = false;
+  }
+  std::cout << "]}\n";
+  return EXIT_SUCCESS;
+}
+} // namespace
+} // namespace sbash64::budget
+
+int main(int argc, char *argv[]) { return sbash64::budget::run(argc, argv); }
@@ -0,0 +1,66 @@
+#ifndef SBASH64_BUDGET_BENCH_STREAMS_HPP_
+#define SBASH64_BUDGET_BENCH_STREAMS_HPP_
+
+#include <sbash64/budget/serialization.hpp>
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+
+namespace sbash64::budget {
+// Reads a string in place, where std::istringstream would copy it.
+class StringViewBuffer : public std::streambuf {
+public:
+  explicit StringViewBuffer(std::string_view s) {
+    auto *begin{const_cast<char *>(s.data())};
+    setg(begin, begin, begin + s.size());
+  }
+};
+
+class StringViewStream : public std::istream {
+public:
+  explicit StringViewStream(std::string_view s)
+      : std::istream{&buffer}, buffer{s} {}
+
+private:
+  StringViewBuffer buffer;
+};
+
+class DiscardingBuffer : public std::streambuf {
+protected:
+  auto overflow(int_type c) -> int_type override { return c; }
+
+  auto xsputn(const char_type *, std::streamsize n)
+      -> std::streamsize override {
+    return n;
+  }
+};
+
+class DiscardingStream : public std::ostream {
+public:
+  DiscardingStream() : std::ostream{&buffer} {}
+
+private:
+  DiscardingBuffer buffer;
+};
+
+class InMemoryStreamFactory : public IoStreamFactory {
+public:
+  explicit InMemoryStreamFactory(std::string_view file) : file{file} {}
+
+  auto makeInput() -> std::shared_ptr<std::istream> override {
+    return std::make_shared<StringViewStream>(file);
+  }
+
+  auto makeOutput() -> std::shared_ptr<std::ostream> override {
+    return std::make_shared<DiscardingStream>();
+  }
+
+private:
+  std::string_view file;
+};
+} // namespace sbash64::budget
+
+#endif
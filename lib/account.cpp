@@ -1,20 +1,13 @@
 #include "account.hpp"
 #include "domain.hpp"
+#include "memory.hpp"
 
 #include <algorithm>
 #include <functional>
 #include <iterator>
-#include <numeric>
+#include <stdexcept>
 
 namespace sbash64::budget {
-static auto balance(const AccountInMemory::TransactionsType &transactions)
-    -> USD {
-  return accumulate(transactions.begin(), transactions.end(), USD{0},
-                    [](USD total, const auto &transaction) {
-                      return total + transaction->amount();
-                    });
-}
-
 static void verify(const Transaction &toVerify,
                    AccountInMemory::TransactionsType &transactions) {
   for (const auto &transaction : transactions)
@@ -42,24 +35,41 @@ make(ObservableTransaction::Factory &factory,
 }
 
 static void notifyUpdatedBalance(
-    const AccountInMemory::TransactionsType &transactions,
+    USD balance,
     const std::vector<std::reference_wrapper<Account::Observer>> &observers) {
   for (auto observer : observers)
-    observer.get().notifyThatBalanceHasChanged(balance(transactions));
+    observer.get().notifyThatBalanceHasChanged(balance);
+}
+
+// A transaction whose ID is already in use is removed instead.
+static void append(AccountInMemory::TransactionsType &transactions,
+                   AccountInMemory::TransactionsByIdType &transactionsById,
+                   std::shared_ptr<ObservableTransaction> transaction) {
+  const auto id{transaction->id()};
+  if (transactionsById.contains(id)) {
+    transaction->remove();
+    throw std::runtime_error{"Transaction ID is already in use"};
+  }
+  transactions.push_back(std::move(transaction));
+  transactionsById.emplace(id, std::prev(transactions.end()));
 }
 
 static void
 add(AccountInMemory::TransactionsType &transactions,
+    AccountInMemory::TransactionsByIdType &transactionsById, USD &balance,
     ObservableTransaction::Factory &factory,
     const std::vector<std::reference_wrapper<Account::Observer>> &observer,
     const Transaction &transaction) {
-  transactions.push_back(make(factory, observer, transaction));
-  notifyUpdatedBalance(transactions, observer);
+  append(transactions, transactionsById,
+         make(factory, observer, transaction));
+  balance += transactions.back()->amount();
+  notifyUpdatedBalance(balance, observer);
 }
 
 static void addTransaction(
     AccountInMemory::TransactionsType &transactions,
-    AccountInMemory::TransactionsType &archived,
+    AccountInMemory::ArchivedTransactionsType &archived,
+    AccountInMemory::TransactionsByIdType &transactionsById, USD &balance,
     ObservableTransaction::Factory &factory,
     const std::vector<std::reference_wrapper<Account::Observer>> &observer,
     TransactionDeserialization &deserialization) {
@@ -72,13 +82,15 @@ static void addTransaction(
     transaction->archive();
     archived.push_back(transaction);
   } else {
-    transactions.push_back(transaction);
+    append(transactions, transactionsById, transaction);
+    balance += transaction->amount();
   };
-  notifyUpdatedBalance(transactions, observer);
+  notifyUpdatedBalance(balance, observer);
 }
 
 static void
 remove(AccountInMemory::TransactionsType &transactions,
+       AccountInMemory::TransactionsByIdType &transactionsById, USD &balance,
        const std::vector<std::reference_wrapper<Account::Observer>> &observer,
        const Transaction &toRemove) {
   if (const auto found = std::find_if(transactions.begin(), transactions.end(),
@@ -86,12 +98,30 @@ remove(AccountInMemory::TransactionsType &transactions,
                                         return transaction->removes(toRemove);
                                       });
       found != transactions.end()) {
+    transactionsById.erase((*found)->id());
+    balance -= (*found)->amount();
     transactions.erase(found);
-    notifyUpdatedBalance(transactions, observer);
+    notifyUpdatedBalance(balance, observer);
   }
 }
 
-static void clear(AccountInMemory::TransactionsType &records) {
+static void
+remove(AccountInMemory::TransactionsType &transactions,
+       AccountInMemory::TransactionsByIdType &transactionsById, USD &balance,
+       const std::vector<std::reference_wrapper<Account::Observer>> &observer,
+       TransactionId id) {
+  const auto found{transactionsById.find(id)};
+  if (found == transactionsById.end())
+    return;
+  const auto transaction{found->second};
+  transactionsById.erase(found);
+  (*transaction)->remove();
+  balance -= (*transaction)->amount();
+  transactions.erase(transaction);
+  notifyUpdatedBalance(balance, observer);
+}
+
+template <typename Transactions> static void clear(Transactions &records) {
   for (const auto &record : records)
     record->remove();
   records.clear();
@@ -106,27 +136,32 @@ static void notifyUpdatedAllocation(
 
 static void resolveVerifiedTransactions(
     AccountInMemory::TransactionsType &transactions,
-    AccountInMemory::TransactionsType &archived, USD &allocation,
+    AccountInMemory::ArchivedTransactionsType &archived,
+    AccountInMemory::TransactionsByIdType &transactionsById, USD &balance,
+    USD &allocation,
     const std::function<void(USD &, const std::shared_ptr<ObservableTransaction>
                                         &)> &updateAllocation,
     const std::vector<std::reference_wrapper<Account::Observer>> &observers) {
-  const auto firstNotVerified{std::partition(
-      transactions.begin(), transactions.end(),
-      [](const auto &transaction) { return transaction->verified(); })};
-  std::for_each(transactions.begin(), firstNotVerified,
-                [&](const auto &transaction) {
-                  updateAllocation(allocation, transaction);
-                  transaction->archive();
-                });
-  archived.insert(archived.end(), std::make_move_iterator(transactions.begin()),
-                  std::make_move_iterator(firstNotVerified));
-  transactions.erase(transactions.begin(), firstNotVerified);
+  for (auto transaction{transactions.begin()};
+       transaction != transactions.end();) {
+    if (!(*transaction)->verified()) {
+      ++transaction;
+      continue;
+    }
+    updateAllocation(allocation, *transaction);
+    balance -= (*transaction)->amount();
+    (*transaction)->archive();
+    transactionsById.erase((*transaction)->id());
+    archived.push_back(std::move(*transaction));
+    transaction = transactions.erase(transaction);
+  }
   notifyUpdatedAllocation(observers, allocation);
-  notifyUpdatedBalance(transactions, observers);
+  notifyUpdatedBalance(balance, observers);
 }
 
-static auto collect(const AccountInMemory::TransactionsType &transactions,
-                    const AccountInMemory::TransactionsType &archived)
+static auto
+collect(const AccountInMemory::TransactionsType &transactions,
+        const AccountInMemory::ArchivedTransactionsType &archived)
     -> std::vector<SerializableTransaction *> {
   std::vector<SerializableTransaction *> collected;
   collected.reserve(transactions.size() + archived.size());
@@ -143,17 +178,61 @@ AccountInMemory::AccountInMemory(ObservableTransaction::Factory &factory)
 void AccountInMemory::attach(Observer &a) { observers.push_back(std::ref(a)); }
 
 void AccountInMemory::add(const Transaction &transaction) {
-  budget::add(transactions, factory, observers, transaction);
+  budget::add(transactions, transactionsById, balance_, factory, observers,
+              transaction);
 }
 
 void AccountInMemory::remove(const Transaction &transaction) {
-  budget::remove(transactions, observers, transaction);
+  budget::remove(transactions, transactionsById, balance_, observers,
+                 transaction);
+}
+
+void AccountInMemory::remove(TransactionId id) {
+  budget::remove(transactions, transactionsById, balance_, observers, id);
 }
 
 void AccountInMemory::verify(const Transaction &transaction) {
   budget::verify(transaction, transactions);
 }
 
+void AccountInMemory::verify(TransactionId id) {
+  if (const auto found{transactionsById.find(id)};
+      found != transactionsById.end())
+    (*found->second)->verify();
+}
+
+void AccountInMemory::update(TransactionId id,
+                             const Transaction &transaction) {
+  const auto found{transactionsById.find(id)};
+  if (found == transactionsById.end())
+    return;
+  const auto &updated{*found->second};
+  balance_ -= updated->amount();
+  updated->update(transaction);
+  balance_ += updated->amount();
+  notifyUpdatedBalance(balance_, observers);
+}
+
+auto AccountInMemory::release(TransactionId id)
+    -> std::shared_ptr<ObservableTransaction> {
+  const auto found{transactionsById.find(id)};
+  if (found == transactionsById.end())
+    return nullptr;
+  auto transaction{std::move(*found->second)};
+  transactions.erase(found->second);
+  transactionsById.erase(found);
+  balance_ -= transaction->amount();
+  notifyUpdatedBalance(balance_, observers);
+  return transaction;
+}
+
+void AccountInMemory::adopt(
+    std::shared_ptr<ObservableTransaction> transaction) {
+  append(transactions, transactionsById, std::move(transaction));
+  balance_ += transactions.back()->amount();
+  notifyUpdatedBalance(balance_, observers);
+}
+
 void AccountInMemory::save(AccountSerialization &serialization) {
   serialization.save(collect(transactions, archived), allocation);
 }
@@ -164,12 +243,13 @@ void AccountInMemory::load(AccountDeserialization &deserialization) {
 
 void AccountInMemory::notifyThatIsReady(
     TransactionDeserialization &deserialization) {
-  addTransaction(transactions, archived, factory, observers, deserialization);
+  addTransaction(transactions, archived, transactionsById, balance_, factory,
+                 observers, deserialization);
 }
 
 void AccountInMemory::increaseAllocationByResolvingVerifiedTransactions() {
   resolveVerifiedTransactions(
-      transactions, archived, allocation,
+      transactions, archived, transactionsById, balance_, allocation,
       [](USD &allocation_,
          const std::shared_ptr<ObservableTransaction> &transaction) {
         allocation_ += transaction->amount();
@@ -179,7 +259,7 @@ void AccountInMemory::increaseAllocationByResolvingVerifiedTransactions() {
 
 void AccountInMemory::decreaseAllocationByResolvingVerifiedTransactions() {
   resolveVerifiedTransactions(
-      transactions, archived, allocation,
+      transactions, archived, transactionsById, balance_, allocation,
       [](USD &allocation_,
          const std::shared_ptr<ObservableTransaction> &transaction) {
         allocation_ -= transaction->amount();
@@ -187,13 +267,33 @@ void AccountInMemory::decreaseAllocationByResolvingVerifiedTransactions() {
       observers);
 }
 
-auto AccountInMemory::balance() -> USD { return budget::balance(transactions); }
+auto AccountInMemory::balance() -> USD { return balance_; }
 
 void AccountInMemory::rename(std::string_view name) {
   for (auto observer : observers)
     observer.get().notifyThatNameHasChanged(name);
 }
 
+template <typename Transactions>
+static void count(std::size_t &objects, AccountMemory &memory,
+                  const Transactions &transactions) {
+  objects += heapBytes(transactions);
+  for (const auto &transaction : transactions) {
+    const auto counted{transaction->memory()};
+    objects += sharedControlBlockBytes + counted.object;
+    memory.descriptions += counted.description;
+    memory.observers += counted.observers;
+  }
+}
+
+auto AccountInMemory::memory() -> AccountMemory {
+  AccountMemory memory{heapBytes(transactionsById), 0, 0,
+                       heapBytes(observers)};
+  count(memory.transactions, memory, transactions);
+  count(memory.archivedTransactions, memory, archived);
+  return memory;
+}
+
 void AccountInMemory::remove() {
   for (auto observer : observers)
     observer.get().notifyThatWillBeRemoved();
@@ -202,9 +302,11 @@ void AccountInMemory::remove() {
 void AccountInMemory::clear() {
   budget::clear(transactions);
   budget::clear(archived);
+  transactionsById.clear();
+  balance_.cents = 0;
   allocation.cents = 0;
   notifyUpdatedAllocation(observers, allocation);
-  notifyUpdatedBalance(transactions, observers);
+  notifyUpdatedBalance(balance_, observers);
 }
 
 void AccountInMemory::increaseAllocationBy(USD usd) {
@@ -1,6 +1,8 @@
 #include "budget.hpp"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -27,6 +29,12 @@ static void verify(const std::shared_ptr<Account> &account,
   verify(*account, transaction);
 }
 
+static void verify(Account &account, TransactionId id) { account.verify(id); }
+
+static void verify(const std::shared_ptr<Account> &account, TransactionId id) {
+  verify(*account, id);
+}
+
 static void remove(Account &account, const Transaction &transaction) {
   account.remove(transaction);
 }
@@ -36,6 +44,22 @@ static void remove(const std::shared_ptr<Account> &account,
   remove(*account, transaction);
 }
 
+static void remove(Account &account, TransactionId id) { account.remove(id); }
+
+static void remove(const std::shared_ptr<Account> &account, TransactionId id) {
+  remove(*account, id);
+}
+
+static void update(Account &account, TransactionId id,
+                   const Transaction &transaction) {
+  account.update(id, transaction);
+}
+
+static void update(const std::shared_ptr<Account> &account, TransactionId id,
+                   const Transaction &transaction) {
+  update(*account, id, transaction);
+}
+
 static auto leftoverAfterExpenses(Account &account) -> USD {
   return account.allocated() - account.balance();
 }
@@ -148,6 +172,12 @@ void BudgetInMemory::removeIncome(const Transaction &transaction) {
   notifyThatHasUnsavedChanges(observers);
 }
 
+void BudgetInMemory::removeIncome(TransactionId id) {
+  remove(incomeAccount, id);
+  notifyThatNetIncomeHasChanged(observers, incomeAccount, expenseAccounts);
+  notifyThatHasUnsavedChanges(observers);
+}
+
 void BudgetInMemory::removeExpense(std::string_view accountName,
                                    const Transaction &transaction) {
   if (contains(expenseAccounts, accountName)) {
@@ -157,11 +187,25 @@ void BudgetInMemory::removeExpense(std::string_view accountName,
   }
 }
 
+void BudgetInMemory::removeExpense(std::string_view accountName,
+                                   TransactionId id) {
+  if (contains(expenseAccounts, accountName)) {
+    remove(at(expenseAccounts, accountName), id);
+    notifyThatNetIncomeHasChanged(observers, incomeAccount, expenseAccounts);
+    notifyThatHasUnsavedChanges(observers);
+  }
+}
+
 void BudgetInMemory::verifyIncome(const Transaction &transaction) {
   verify(incomeAccount, transaction);
   notifyThatHasUnsavedChanges(observers);
 }
 
+void BudgetInMemory::verifyIncome(TransactionId id) {
+  verify(incomeAccount, id);
+  notifyThatHasUnsavedChanges(observers);
+}
+
 void BudgetInMemory::verifyExpense(std::string_view accountName,
                                    const Transaction &transaction) {
   if (contains(expenseAccounts, accountName)) {
@@ -170,6 +214,45 @@ void BudgetInMemory::verifyExpense(std::string_view accountName,
   }
 }
 
+void BudgetInMemory::verifyExpense(std::string_view accountName,
+                                   TransactionId id) {
+  if (contains(expenseAccounts, accountName)) {
+    verify(at(expenseAccounts, accountName), id);
+    notifyThatHasUnsavedChanges(observers);
+  }
+}
+
+void BudgetInMemory::updateIncome(TransactionId id,
+                                  const Transaction &transaction) {
+  update(incomeAccount, id, transaction);
+  notifyThatNetIncomeHasChanged(observers, incomeAccount, expenseAccounts);
+  notifyThatHasUnsavedChanges(observers);
+}
+
+void BudgetInMemory::updateExpense(std::string_view accountName,
+                                   TransactionId id,
+                                   const Transaction &transaction) {
+  if (contains(expenseAccounts, accountName)) {
+    update(at(expenseAccounts, accountName), id, transaction);
+    notifyThatNetIncomeHasChanged(observers, incomeAccount, expenseAccounts);
+    notifyThatHasUnsavedChanges(observers);
+  }
+}
+
+// Expense balances only change hands, so net income stays the same.
+void BudgetInMemory::moveExpense(std::string_view from, std::string_view to,
+                                 TransactionId id) {
+  if (from == to || !contains(expenseAccounts, from) ||
+      !contains(expenseAccounts, to))
+    return;
+  if (auto transaction{at(expenseAccounts, from)->release(id)}) {
+    at(expenseAccounts, to)->adopt(std::move(transaction));
+    for (auto observer : observers)
+      observer.get().notifyThatExpenseHasMoved(from, to, id);
+    notifyThatHasUnsavedChanges(observers);
+  }
+}
+
 static void transfer(Account &from, Account &to, USD amount) {
   from.decreaseAllocationBy(amount);
   to.increaseAllocationBy(amount);
@@ -235,6 +318,14 @@ void BudgetInMemory::renameAccount(std::string_view from, std::string_view to) {
   notifyThatHasUnsavedChanges(observers);
 }
 
+auto BudgetInMemory::memory()
+    -> std::map<std::string, AccountMemory, std::less<>> {
+  std::map<std::string, AccountMemory, std::less<>> memory;
+  for (const auto &[name, account] : expenseAccounts)
+    memory.emplace(name, account->memory());
+  return memory;
+}
+
 void BudgetInMemory::removeAccount(std::string_view name) {
   if (contains(expenseAccounts, name)) {
     remove(expenseAccounts, name);
@@ -283,4 +374,160 @@ void BudgetInMemory::restore() {
       transfer(expenseAccounts, name, incomeAccount, -amount, observers);
   }
 }
+
+InstrumentedBudget::InstrumentedBudget(Budget &budget) : budget{budget} {}
+
+template <typename F>
+void InstrumentedBudget::measure(Operation operation, F f) {
+  const auto start{std::chrono::steady_clock::now()};
+  f();
+  const auto elapsed{std::chrono::steady_clock::now() - start};
+  auto &counter{counters.at(static_cast<std::size_t>(operation))};
+  counter.calls.fetch_add(1, std::memory_order_relaxed);
+  counter.nanoseconds.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+      std::memory_order_relaxed);
+}
+
+void InstrumentedBudget::attach(Observer &observer) { budget.attach(observer); }
+
+void InstrumentedBudget::addIncome(const Transaction &transaction) {
+  measure(Operation::addIncome, [&] { budget.addIncome(transaction); });
+}
+
+void InstrumentedBudget::addExpense(std::string_view accountName,
+                                    const Transaction &transaction) {
+  measure(Operation::addExpense,
+          [&] { budget.addExpense(accountName, transaction); });
+}
+
+void InstrumentedBudget::removeIncome(const Transaction &transaction) {
+  measure(Operation::removeIncome, [&] { budget.removeIncome(transaction); });
+}
+
+void InstrumentedBudget::removeIncome(TransactionId id) {
+  measure(Operation::removeIncome, [&] { budget.removeIncome(id); });
+}
+
+void InstrumentedBudget::removeExpense(std::string_view accountName,
+                                       const Transaction &transaction) {
+  measure(Operation::removeExpense,
+          [&] { budget.removeExpense(accountName, transaction); });
+}
+
+void InstrumentedBudget::removeExpense(std::string_view accountName,
+                                       TransactionId id) {
+  measure(Operation::removeExpense,
+          [&] { budget.removeExpense(accountName, id); });
+}
+
+void InstrumentedBudget::verifyIncome(const Transaction &transaction) {
+  measure(Operation::verifyIncome, [&] { budget.verifyIncome(transaction); });
+}
+
+void InstrumentedBudget::verifyIncome(TransactionId id) {
+  measure(Operation::verifyIncome, [&] { budget.verifyIncome(id); });
+}
+
+void InstrumentedBudget::verifyExpense(std::string_view accountName,
+                                       const Transaction &transaction) {
+  measure(Operation::verifyExpense,
+          [&] { budget.verifyExpense(accountName, transaction); });
+}
+
+void InstrumentedBudget::verifyExpense(std::string_view accountName,
+                                       TransactionId id) {
+  measure(Operation::verifyExpense,
+          [&] { budget.verifyExpense(accountName, id); });
+}
+
+void InstrumentedBudget::updateIncome(TransactionId id,
+                                      const Transaction &transaction) {
+  measure(Operation::updateIncome,
+          [&] { budget.updateIncome(id, transaction); });
+}
+
+void InstrumentedBudget::updateExpense(std::string_view accountName,
+                                       TransactionId id,
+                                       const Transaction &transaction) {
+  measure(Operation::updateExpense,
+          [&] { budget.updateExpense(accountName, id, transaction); });
+}
+
+void InstrumentedBudget::moveExpense(std::string_view from,
+                                     std::string_view to, TransactionId id) {
+  measure(Operation::moveExpense, [&] { budget.moveExpense(from, to, id); });
+}
+
+void InstrumentedBudget::transferTo(std::string_view accountName,
+                                    USD amount) {
+  measure(Operation::transferTo,
+          [&] { budget.transferTo(accountName, amount); });
+}
+
+void InstrumentedBudget::allocate(std::string_view accountName, USD amount) {
+  measure(Operation::allocate, [&] { budget.allocate(accountName, amount); });
+}
+
+void InstrumentedBudget::createAccount(std::string_view name) {
+  measure(Operation::createAccount, [&] { budget.createAccount(name); });
+}
+
+void InstrumentedBudget::closeAccount(std::string_view name) {
+  measure(Operation::closeAccount, [&] { budget.closeAccount(name); });
+}
+
+void InstrumentedBudget::removeAccount(std::string_view name) {
+  measure(Operation::removeAccount, [&] { budget.removeAccount(name); });
+}
+
+void InstrumentedBudget::renameAccount(std::string_view from,
+                                       std::string_view to) {
+  measure(Operation::renameAccount, [&] { budget.renameAccount(from, to); });
+}
+
+void InstrumentedBudget::reduce() {
+  measure(Operation::reduce, [&] { budget.reduce(); });
+}
+
+void InstrumentedBudget::restore() {
+  measure(Operation::restore, [&] { budget.restore(); });
+}
+
+void InstrumentedBudget::save(BudgetSerialization &serialization) {
+  measure(Operation::save, [&] { budget.save(serialization); });
+}
+
+void InstrumentedBudget::load(BudgetDeserialization &deserialization) {
+  measure(Operation::load, [&] { budget.load(deserialization); });
+}
+
+void InstrumentedBudget::notifyThatIncomeAccountIsReady(
+    AccountDeserialization &deserialization) {
+  budget.notifyThatIncomeAccountIsReady(deserialization);
+}
+
+void InstrumentedBudget::notifyThatExpenseAccountIsReady(
+    AccountDeserialization &deserialization, std::string_view name) {
+  budget.notifyThatExpenseAccountIsReady(deserialization, name);
+}
+
+auto InstrumentedBudget::snapshot() const -> std::vector<Count> {
+  constexpr std::array<std::string_view, std::tuple_size_v<decltype(counters)>>
+      names{"addIncome",     "addExpense",    "removeIncome",
+            "removeExpense", "verifyIncome",  "verifyExpense",
+            "updateIncome",  "updateExpense", "moveExpense",
+            "transferTo",    "allocate",      "createAccount",
+            "removeAccount", "renameAccount", "closeAccount",
+            "restore",       "reduce",        "save",
+            "load"};
+  std::vector<Count> counts;
+  counts.reserve(counters.size());
+  for (std::size_t i{0}; i < counters.size(); ++i)
+    counts.push_back(
+        {names.at(i), counters.at(i).calls.load(std::memory_order_relaxed),
+         std::chrono::nanoseconds{
+             counters.at(i).nanoseconds.load(std::memory_order_relaxed)}});
+  return counts;
+}
 } // namespace sbash64::budget
@@ -4,13 +4,21 @@
 #include "domain.hpp"
 
 #include <functional>
+#include <list>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace sbash64::budget {
 class AccountInMemory : public Account {
 public:
-  using TransactionsType = std::vector<std::shared_ptr<ObservableTransaction>>;
+  // Listed, in the order they came, so that one found by ID is removed in
+  // constant time.
+  using TransactionsType = std::list<std::shared_ptr<ObservableTransaction>>;
+  using ArchivedTransactionsType =
+      std::vector<std::shared_ptr<ObservableTransaction>>;
+  using TransactionsByIdType =
+      std::unordered_map<TransactionId, TransactionsType::iterator>;
 
   explicit AccountInMemory(ObservableTransaction::Factory &);
   void attach(Observer &) override;
@@ -27,9 +35,16 @@ public:
   void save(AccountSerialization &) override;
   void add(const Transaction &) override;
   void verify(const Transaction &) override;
+  void verify(TransactionId) override;
   void remove(const Transaction &) override;
+  void remove(TransactionId) override;
+  void update(TransactionId, const Transaction &) override;
+  auto release(TransactionId)
+      -> std::shared_ptr<ObservableTransaction> override;
+  void adopt(std::shared_ptr<ObservableTransaction>) override;
   auto balance() -> USD override;
   void rename(std::string_view) override;
+  auto memory() -> AccountMemory override;
 
   class Factory : public Account::Factory {
   public:
@@ -42,9 +57,13 @@ public:
 
 private:
   TransactionsType transactions;
-  TransactionsType archived;
+  ArchivedTransactionsType archived;
+  // Indexes transactions, not those archived. No two share an ID.
+  TransactionsByIdType transactionsById;
   std::vector<std::reference_wrapper<Observer>> observers{};
   ObservableTransaction::Factory &factory;
+  // The sum of transactions, kept as they come and go.
+  USD balance_{};
   USD allocation{};
 };
 } // namespace sbash64::budget
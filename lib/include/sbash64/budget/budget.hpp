@@ -3,10 +3,15 @@
 
 #include "domain.hpp"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace sbash64::budget {
@@ -20,11 +25,20 @@ public:
   void addIncome(const Transaction &) override;
   void addExpense(std::string_view accountName, const Transaction &) override;
   void removeIncome(const Transaction &) override;
+  void removeIncome(TransactionId) override;
   void removeExpense(std::string_view accountName,
                      const Transaction &) override;
+  void removeExpense(std::string_view accountName, TransactionId) override;
   void verifyIncome(const Transaction &) override;
+  void verifyIncome(TransactionId) override;
   void verifyExpense(std::string_view accountName,
                      const Transaction &) override;
+  void verifyExpense(std::string_view accountName, TransactionId) override;
+  void updateIncome(TransactionId, const Transaction &) override;
+  void updateExpense(std::string_view accountName, TransactionId,
+                     const Transaction &) override;
+  void moveExpense(std::string_view from, std::string_view to,
+                   TransactionId) override;
   void transferTo(std::string_view accountName, USD amount) override;
   void allocate(std::string_view accountName, USD) override;
   void createAccount(std::string_view name) override;
@@ -38,6 +52,8 @@ public:
   void notifyThatIncomeAccountIsReady(AccountDeserialization &) override;
   void notifyThatExpenseAccountIsReady(AccountDeserialization &,
                                        std::string_view name) override;
+  // The expense accounts by name.
+  auto memory() -> std::map<std::string, AccountMemory, std::less<>>;
 
 private:
   ExpenseAccountsType expenseAccounts;
@@ -45,6 +61,88 @@ private:
   Account::Factory &accountFactory;
   std::vector<std::reference_wrapper<Observer>> observers{};
 };
+
+// Counts the calls to another budget and the time they take, by operation.
+// Overloads count as one operation. The counters are relaxed atomics written
+// only by the budget's one user, so they cost little, and any thread may take
+// a snapshot.
+class InstrumentedBudget : public Budget {
+public:
+  struct Count {
+    std::string_view operation;
+    std::uint_least64_t calls;
+    std::chrono::nanoseconds time;
+  };
+
+  explicit InstrumentedBudget(Budget &);
+  void attach(Observer &) override;
+  void addIncome(const Transaction &) override;
+  void addExpense(std::string_view accountName, const Transaction &) override;
+  void removeIncome(const Transaction &) override;
+  void removeIncome(TransactionId) override;
+  void removeExpense(std::string_view accountName,
+                     const Transaction &) override;
+  void removeExpense(std::string_view accountName, TransactionId) override;
+  void verifyIncome(const Transaction &) override;
+  void verifyIncome(TransactionId) override;
+  void verifyExpense(std::string_view accountName,
+                     const Transaction &) override;
+  void verifyExpense(std::string_view accountName, TransactionId) override;
+  void updateIncome(TransactionId, const Transaction &) override;
+  void updateExpense(std::string_view accountName, TransactionId,
+                     const Transaction &) override;
+  void moveExpense(std::string_view from, std::string_view to,
+                   TransactionId) override;
+  void transferTo(std::string_view accountName, USD amount) override;
+  void allocate(std::string_view accountName, USD) override;
+  void createAccount(std::string_view name) override;
+  void closeAccount(std::string_view name) override;
+  void removeAccount(std::string_view name) override;
+  void renameAccount(std::string_view from, std::string_view to) override;
+  void reduce() override;
+  void restore() override;
+  void save(BudgetSerialization &) override;
+  void load(BudgetDeserialization &) override;
+  void notifyThatIncomeAccountIsReady(AccountDeserialization &) override;
+  void notifyThatExpenseAccountIsReady(AccountDeserialization &,
+                                       std::string_view name) override;
+  // Every operation, in the order of the Budget interface.
+  [[nodiscard]] auto snapshot() const -> std::vector<Count>;
+
+private:
+  enum class Operation {
+    addIncome,
+    addExpense,
+    removeIncome,
+    removeExpense,
+    verifyIncome,
+    verifyExpense,
+    updateIncome,
+    updateExpense,
+    moveExpense,
+    transferTo,
+    allocate,
+    createAccount,
+    removeAccount,
+    renameAccount,
+    closeAccount,
+    restore,
+    reduce,
+    save,
+    load
+  };
+
+  struct Counter {
+    std::atomic<std::uint_least64_t> calls;
+    std::atomic<std::int_least64_t> nanoseconds;
+  };
+
+  template <typename F> void measure(Operation, F);
+
+  Budget &budget;
+  std::array<Counter, static_cast<std::size_t>(Operation::load) + 1>
+      counters{};
+};
 } // namespace sbash64::budget
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef SBASH64_BUDGET_DOMAIN_HPP_
 #define SBASH64_BUDGET_DOMAIN_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -77,6 +78,10 @@ struct Transaction {
   auto operator==(const Transaction &) const -> bool = default;
 };
 
+// Names a transaction while its budget is in memory. IDs are not saved; a
+// loaded budget's transactions get new ones.
+using TransactionId = std::uint_least64_t;
+
 struct ArchivableVerifiableTransaction : Transaction {
   bool verified{};
   bool archived{};
@@ -103,6 +108,15 @@ public:
   virtual void save(TransactionSerialization &) = 0;
 };
 
+// Approximate heap bytes held by a transaction: the object itself, beyond
+// any shared control block, and what its description and observer list
+// allocate.
+struct TransactionMemory {
+  std::size_t object;
+  std::size_t description;
+  std::size_t observers;
+};
+
 class ObservableTransaction : public SerializableTransaction {
 public:
   class Observer {
@@ -117,15 +131,21 @@ public:
   virtual void attach(Observer &) = 0;
   virtual void initialize(const Transaction &) = 0;
   virtual auto verifies(const Transaction &) -> bool = 0;
+  virtual void verify() = 0;
+  // Replaces the amount, description and date, keeping whether verified.
+  virtual void update(const Transaction &) = 0;
   virtual auto verified() -> bool = 0;
   virtual auto removes(const Transaction &) -> bool = 0;
   virtual void remove() = 0;
   virtual void archive() = 0;
   virtual auto amount() -> USD = 0;
+  virtual auto id() -> TransactionId = 0;
+  virtual auto memory() -> TransactionMemory = 0;
 
   class Factory {
   public:
     SBASH64_BUDGET_INTERFACE_SPECIAL_MEMBER_FUNCTIONS(Factory);
+    // Each transaction made has an ID unique to this factory.
     virtual auto make() -> std::shared_ptr<ObservableTransaction> = 0;
   };
 };
@@ -157,6 +177,16 @@ public:
   virtual void load(AccountDeserialization &) = 0;
 };
 
+// Approximate heap bytes held by an account, from container capacities.
+// Transactions include their slots and index; descriptions and observers
+// include those of every transaction, archived or not.
+struct AccountMemory {
+  std::size_t transactions;
+  std::size_t archivedTransactions;
+  std::size_t descriptions;
+  std::size_t observers;
+};
+
 class Account : public AccountDeserialization::Observer,
                 public SerializableAccount {
 public:
@@ -173,7 +203,15 @@ public:
   virtual void attach(Observer &) = 0;
   virtual void add(const Transaction &) = 0;
   virtual void verify(const Transaction &) = 0;
+  virtual void verify(TransactionId) = 0;
   virtual void remove(const Transaction &) = 0;
+  virtual void remove(TransactionId) = 0;
+  virtual void update(TransactionId, const Transaction &) = 0;
+  // Hands a transaction to another account without removing or adding it as
+  // far as its observers can tell. Releasing an unknown ID returns null.
+  virtual auto release(TransactionId)
+      -> std::shared_ptr<ObservableTransaction> = 0;
+  virtual void adopt(std::shared_ptr<ObservableTransaction>) = 0;
   virtual void increaseAllocationBy(USD) = 0;
   virtual void decreaseAllocationBy(USD) = 0;
   virtual auto allocated() -> USD = 0;
@@ -183,6 +221,7 @@ public:
   virtual void remove() = 0;
   virtual void clear() = 0;
   virtual void rename(std::string_view) = 0;
+  virtual auto memory() -> AccountMemory = 0;
 
   class Factory {
   public:
@@ -226,6 +265,9 @@ public:
     notifyThatExpenseAccountHasBeenCreated(Account &,
                                            std::string_view name) = 0;
     virtual void notifyThatNetIncomeHasChanged(USD) = 0;
+    virtual void notifyThatExpenseHasMoved(std::string_view from,
+                                           std::string_view to,
+                                           TransactionId) = 0;
     virtual void notifyThatHasBeenSaved() = 0;
     virtual void notifyThatHasUnsavedChanges() = 0;
   };
@@ -235,11 +277,20 @@ public:
   virtual void addExpense(std::string_view accountName,
                           const Transaction &) = 0;
   virtual void removeIncome(const Transaction &) = 0;
+  virtual void removeIncome(TransactionId) = 0;
   virtual void removeExpense(std::string_view accountName,
                              const Transaction &) = 0;
+  virtual void removeExpense(std::string_view accountName, TransactionId) = 0;
   virtual void verifyIncome(const Transaction &) = 0;
+  virtual void verifyIncome(TransactionId) = 0;
   virtual void verifyExpense(std::string_view accountName,
                              const Transaction &) = 0;
+  virtual void verifyExpense(std::string_view accountName, TransactionId) = 0;
+  virtual void updateIncome(TransactionId, const Transaction &) = 0;
+  virtual void updateExpense(std::string_view accountName, TransactionId,
+                             const Transaction &) = 0;
+  virtual void moveExpense(std::string_view from, std::string_view to,
+                           TransactionId) = 0;
   virtual void transferTo(std::string_view accountName, USD) = 0;
   virtual void allocate(std::string_view accountName, USD) = 0;
   virtual void createAccount(std::string_view name) = 0;
@@ -0,0 +1,90 @@
+#ifndef SBASH64_BUDGET_MEMORY_HPP_
+#define SBASH64_BUDGET_MEMORY_HPP_
+
+#include "budget.hpp"
+#include "domain.hpp"
+#include "presentation.hpp"
+#include "ranked.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sbash64::budget {
+// Estimates of what the standard containers allocate, close enough to the
+// layouts of libstdc++ and libc++ to compare accounts with each other.
+// Allocator overhead per block is left out.
+
+// What std::make_shared puts before the object: a vtable pointer and two
+// counts.
+constexpr std::size_t sharedControlBlockBytes{sizeof(void *) +
+                                              2 * sizeof(int)};
+
+inline auto heapBytes(const std::string &s) -> std::size_t {
+  const auto *const self{reinterpret_cast<const char *>(&s)};
+  // A short string lives inside the object.
+  if (std::greater_equal<>{}(s.data(), self) &&
+      std::less<>{}(s.data(), self + sizeof s))
+    return 0;
+  return s.capacity() + 1;
+}
+
+template <typename T> auto heapBytes(const std::vector<T> &v) -> std::size_t {
+  return v.capacity() * sizeof(T);
+}
+
+// Each node holds two pointers besides the value.
+template <typename T> auto heapBytes(const std::list<T> &list) -> std::size_t {
+  return list.size() * (2 * sizeof(void *) + sizeof(T));
+}
+
+// Each node holds a next pointer and the value. The hash of an integer key
+// is not cached.
+template <typename K, typename V, typename H, typename E>
+auto heapBytes(const std::unordered_map<K, V, H, E> &map) -> std::size_t {
+  return map.bucket_count() * sizeof(void *) +
+         map.size() * (sizeof(void *) + sizeof(std::pair<const K, V>));
+}
+
+// Each node holds three pointers and a color besides the value.
+template <typename T, typename C>
+auto heapBytes(const std::set<T, C> &set) -> std::size_t {
+  return set.size() * (4 * sizeof(void *) + sizeof(T));
+}
+
+template <typename T, typename L>
+auto heapBytes(const RankedSet<T, L> &set) -> std::size_t {
+  return set.size() * RankedSet<T, L>::nodeBytes;
+}
+
+struct AccountMemoryReport {
+  std::string name;
+  AccountMemory account;
+  PresenterMemory presenter;
+};
+
+auto total(const AccountMemoryReport &) -> std::size_t;
+
+// The income account first, then the expense accounts by name.
+auto memoryReport(Account &incomeAccount, BudgetInMemory &, BudgetPresenter &)
+    -> std::vector<AccountMemoryReport>;
+
+// What the allocator holds for the whole process, when it says.
+struct AllocatorMemory {
+  std::size_t inUse;
+  std::size_t free;
+};
+
+auto allocatorMemory() -> std::optional<AllocatorMemory>;
+
+// Writes {"total":...,"accounts":[{"name":...,"total":...,...}, ...]}, in
+// bytes.
+void writeMemoryReport(std::string &, const std::vector<AccountMemoryReport> &);
+} // namespace sbash64::budget
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef SBASH64_BUDGET_METRICS_HPP_
+#define SBASH64_BUDGET_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sbash64::budget {
+// Counts durations in buckets an eighth of a doubling wide, as HDR histograms
+// do with three significant bits, from a nanosecond up to about a minute.
+// Longer durations count in the last bucket. Any thread may record while
+// another reads.
+class LatencyHistogram {
+public:
+  void record(std::chrono::nanoseconds);
+  [[nodiscard]] auto count() const -> std::uint_least64_t;
+  [[nodiscard]] auto sum() const -> std::chrono::nanoseconds;
+  // The longest duration that shares a bucket with the recorded one of rank
+  // ceil(q * count), or zero when nothing has been recorded.
+  [[nodiscard]] auto quantile(double q) const -> std::chrono::nanoseconds;
+
+private:
+  static constexpr auto subBuckets{8};
+  static constexpr auto doublings{33};
+
+  std::array<std::atomic<std::uint_least64_t>, subBuckets *(doublings + 1)>
+      counts{};
+  std::atomic<std::uint_least64_t> count_{};
+  std::atomic<std::int_least64_t> sumNanoseconds{};
+};
+
+// Writers of the Prometheus text exposition format. Labels are written as
+// given, as in method="save", and may be empty.
+void writePrometheusHeader(std::string &, std::string_view name,
+                           std::string_view type, std::string_view help);
+void writePrometheusSample(std::string &, std::string_view name,
+                           std::string_view labels, double value);
+// Writes the 0.5, 0.9, 0.99 and 0.999 quantiles, sum and count of a summary,
+// in seconds, over everything recorded so far.
+void writePrometheusSummary(std::string &, std::string_view name,
+                            std::string_view labels,
+                            const LatencyHistogram &);
+} // namespace sbash64::budget
+
+#endif
@@ -2,34 +2,48 @@
 #define SBASH64_BUDGET_PRESENTATION_HPP_
 
 #include "domain.hpp"
+#include "ranked.hpp"
 
 #include <gsl/gsl>
 
+#include <cstddef>
+#include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace sbash64::budget {
 class View {
 public:
   SBASH64_BUDGET_INTERFACE_SPECIAL_MEMBER_FUNCTIONS(View);
-  virtual void updateNetIncome(std::string_view amount) = 0;
+  virtual void updateNetIncome(USD) = 0;
   virtual void addNewAccountTable(std::string_view name,
                                   gsl::index accountIndex) = 0;
   virtual void deleteAccountTable(gsl::index accountIndex) = 0;
   virtual void setAccountName(gsl::index accountIndex,
                               std::string_view name) = 0;
-  virtual void updateAccountAllocation(gsl::index accountIndex,
-                                       std::string_view) = 0;
-  virtual void updateAccountBalance(gsl::index accountIndex,
-                                    std::string_view) = 0;
-  virtual void addTransactionRow(gsl::index accountIndex,
-                                 std::string_view amount, std::string_view date,
-                                 std::string_view description,
-                                 gsl::index transactionIndex) = 0;
+  virtual void updateAccountAllocation(gsl::index accountIndex, USD) = 0;
+  virtual void updateAccountBalance(gsl::index accountIndex, USD) = 0;
+  virtual void addTransactionRow(gsl::index accountIndex, USD amount,
+                                 const Date &, std::string_view description,
+                                 gsl::index transactionIndex,
+                                 TransactionId) = 0;
   virtual void deleteTransactionRow(gsl::index accountIndex,
                                     gsl::index transactionIndex) = 0;
+  // The row moves to newTransactionIndex, counted as if it had been removed
+  // first.
+  virtual void updateTransactionRow(gsl::index accountIndex,
+                                    gsl::index transactionIndex,
+                                    gsl::index newTransactionIndex, USD amount,
+                                    const Date &,
+                                    std::string_view description) = 0;
+  virtual void moveTransactionRow(gsl::index accountIndex,
+                                  gsl::index transactionIndex,
+                                  gsl::index newAccountIndex,
+                                  gsl::index newTransactionIndex) = 0;
   virtual void
   putCheckmarkNextToTransactionRow(gsl::index accountIndex,
                                    gsl::index transactionIndex) = 0;
@@ -42,6 +56,13 @@ public:
 
 class AccountPresenter;
 
+// Approximate heap bytes held by an account's presenter and those of its
+// transactions.
+struct PresenterMemory {
+  std::size_t transactions;
+  std::size_t descriptions;
+};
+
 class TransactionPresenter : public ObservableTransaction::Observer {
 public:
   TransactionPresenter(ObservableTransaction &, const std::set<View *> &,
@@ -51,16 +72,28 @@ public:
   void notifyThatIs(const Transaction &t) override;
   void notifyThatWillBeRemoved() override;
   [[nodiscard]] auto get() const -> const Transaction & { return transaction; }
-  void catchUp(View *);
+  // Orders the presenter by t. Only while it is out of its parent's set.
+  void set(const Transaction &t) { transaction = t; }
+  [[nodiscard]] auto id() const -> TransactionId { return id_; }
+  void catchUp(View *, gsl::index transactionIndex);
+  void reparent(AccountPresenter &);
 
 private:
   Transaction transaction;
+  TransactionId id_;
   const std::set<View *> &views;
-  AccountPresenter &parent;
+  AccountPresenter *parent;
+  bool ordered{};
   bool verified{};
   bool archived{};
 };
 
+// Rows by date, newest first, then by description and amount.
+struct TransactionRowOrder {
+  auto operator()(const TransactionPresenter &,
+                  const TransactionPresenter &) const -> bool;
+};
+
 class AccountPresenter : public Account::Observer {
 public:
   class Parent {
@@ -81,15 +114,20 @@ public:
   void notifyThatWillBeRemoved() override;
   void ready(const TransactionPresenter *);
   void remove(const TransactionPresenter *);
+  void reorder(const TransactionPresenter *, const Transaction &);
+  void move(TransactionId, AccountPresenter &to);
   void catchUp(View *);
   auto index(const TransactionPresenter *) -> gsl::index;
+  [[nodiscard]] auto memory() const -> PresenterMemory;
 
   std::string name;
   Parent &parent;
 
 private:
   std::vector<std::unique_ptr<TransactionPresenter>> unorderedChildren;
-  std::set<std::unique_ptr<TransactionPresenter>, std::less<>> orderedChildren;
+  RankedSet<TransactionPresenter, TransactionRowOrder> orderedChildren;
+  std::unordered_map<TransactionId, const TransactionPresenter *>
+      orderedChildrenById;
   const std::set<View *> &views;
   USD balance{};
   USD allocation{};
@@ -104,13 +142,20 @@ public:
   void notifyThatExpenseAccountHasBeenCreated(Account &,
                                               std::string_view name) override;
   void notifyThatNetIncomeHasChanged(USD) override;
+  void notifyThatExpenseHasMoved(std::string_view from, std::string_view to,
+                                 TransactionId) override;
   void notifyThatHasBeenSaved() override;
   void notifyThatHasUnsavedChanges() override;
   void remove(const AccountPresenter *) override;
   void reorder(const AccountPresenter *, std::string_view newName) override;
   auto index(const AccountPresenter *) -> gsl::index override;
   void add(View *);
+  void attach(View *);
+  void catchUp(View *);
   void remove(View *);
+  // By account name, the income account included.
+  [[nodiscard]] auto memory() const
+      -> std::map<std::string, PresenterMemory, std::less<>>;
 
 private:
   std::set<std::unique_ptr<AccountPresenter>, std::less<>> accounts;
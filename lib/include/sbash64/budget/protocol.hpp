@@ -0,0 +1,215 @@
+#ifndef SBASH64_BUDGET_PROTOCOL_HPP_
+#define SBASH64_BUDGET_PROTOCOL_HPP_
+
+#include "presentation.hpp"
+
+#include <gsl/gsl>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sbash64::budget {
+enum class MessageKind {
+  other,
+  accountIndexChange,
+  accountAllocation,
+  accountBalance,
+  netIncome,
+  savedState
+};
+
+// The order matches messagePackMethods in web/main.ts.
+enum class MessagePackMethod {
+  updateNetIncome,
+  addAccountTable,
+  deleteAccountTable,
+  updateAccountName,
+  updateAccountAllocation,
+  updateAccountBalance,
+  addTransactionRow,
+  deleteTransactionRow,
+  checkTransactionRow,
+  removeTransactionRowSelection,
+  markAsSaved,
+  markAsUnsaved,
+  reorderAccount,
+  updateTransactionRow,
+  moveTransactionRow
+};
+
+// Encoded messages waiting to go out as one frame. A message drops the
+// earlier one of the same kind (and account) unless account indices have
+// changed in between.
+class MessageBatch {
+public:
+  auto begin(MessageKind, gsl::index accountIndex = 0) -> std::string &;
+  void end();
+  // Adds the messages of another batch as if each had begun here, dropping
+  // the bytes of superseded messages once they outweigh the others.
+  void append(const MessageBatch &);
+  [[nodiscard]] auto messages() const -> std::vector<std::string_view>;
+  [[nodiscard]] auto empty() const -> bool;
+  // The bytes of the messages not superseded.
+  [[nodiscard]] auto size() const -> std::string::size_type;
+  void clear();
+
+private:
+  struct Message {
+    std::string::size_type offset;
+    std::string::size_type size;
+    MessageKind kind;
+    gsl::index accountIndex;
+    bool superseded;
+  };
+
+  void supersede(std::optional<std::size_t> &latest);
+
+  std::string buffer;
+  std::string::size_type size_{};
+  std::vector<Message> messages_;
+  std::map<gsl::index, std::optional<std::size_t>> latestAccountAllocations;
+  std::map<gsl::index, std::optional<std::size_t>> latestAccountBalances;
+  std::optional<std::size_t> latestNetIncome;
+  std::optional<std::size_t> latestSavedState;
+};
+
+// Writes the JSON messages understood by web/main.ts.
+class JsonView : public View {
+public:
+  explicit JsonView(MessageBatch &);
+  void updateNetIncome(USD) override;
+  void addNewAccountTable(std::string_view name,
+                          gsl::index accountIndex) override;
+  void deleteAccountTable(gsl::index accountIndex) override;
+  void setAccountName(gsl::index accountIndex, std::string_view name) override;
+  void updateAccountAllocation(gsl::index accountIndex, USD) override;
+  void updateAccountBalance(gsl::index accountIndex, USD) override;
+  void addTransactionRow(gsl::index accountIndex, USD amount, const Date &,
+                         std::string_view description,
+                         gsl::index transactionIndex, TransactionId) override;
+  void deleteTransactionRow(gsl::index accountIndex,
+                            gsl::index transactionIndex) override;
+  void updateTransactionRow(gsl::index accountIndex,
+                            gsl::index transactionIndex,
+                            gsl::index newTransactionIndex, USD amount,
+                            const Date &,
+                            std::string_view description) override;
+  void moveTransactionRow(gsl::index accountIndex,
+                          gsl::index transactionIndex,
+                          gsl::index newAccountIndex,
+                          gsl::index newTransactionIndex) override;
+  void putCheckmarkNextToTransactionRow(gsl::index accountIndex,
+                                        gsl::index transactionIndex) override;
+  void removeTransactionRowSelection(gsl::index accountIndex,
+                                     gsl::index transactionIndex) override;
+  void markAsSaved() override;
+  void markAsUnsaved() override;
+  void reorderAccountIndex(gsl::index from, gsl::index to) override;
+
+private:
+  MessageBatch &batch;
+};
+
+// Writes each message as a MessagePack array of its MessagePackMethod and
+// fields. Amounts stay integer cents and dates are packed as YYYYMMDD so that
+// the client does the formatting.
+class MessagePackView : public View {
+public:
+  explicit MessagePackView(MessageBatch &);
+  void updateNetIncome(USD) override;
+  void addNewAccountTable(std::string_view name,
+                          gsl::index accountIndex) override;
+  void deleteAccountTable(gsl::index accountIndex) override;
+  void setAccountName(gsl::index accountIndex, std::string_view name) override;
+  void updateAccountAllocation(gsl::index accountIndex, USD) override;
+  void updateAccountBalance(gsl::index accountIndex, USD) override;
+  void addTransactionRow(gsl::index accountIndex, USD amount, const Date &,
+                         std::string_view description,
+                         gsl::index transactionIndex, TransactionId) override;
+  void deleteTransactionRow(gsl::index accountIndex,
+                            gsl::index transactionIndex) override;
+  void updateTransactionRow(gsl::index accountIndex,
+                            gsl::index transactionIndex,
+                            gsl::index newTransactionIndex, USD amount,
+                            const Date &,
+                            std::string_view description) override;
+  void moveTransactionRow(gsl::index accountIndex,
+                          gsl::index transactionIndex,
+                          gsl::index newAccountIndex,
+                          gsl::index newTransactionIndex) override;
+  void putCheckmarkNextToTransactionRow(gsl::index accountIndex,
+                                        gsl::index transactionIndex) override;
+  void removeTransactionRowSelection(gsl::index accountIndex,
+                                     gsl::index transactionIndex) override;
+  void markAsSaved() override;
+  void markAsUnsaved() override;
+  void reorderAccountIndex(gsl::index from, gsl::index to) override;
+
+private:
+  MessageBatch &batch;
+};
+
+// Numbers a frame so that a reconnecting client can resume after the last
+// frame it applied. A snapshot replaces everything the client shows.
+struct FrameHeader {
+  std::uint_least64_t sequence;
+  bool snapshot;
+};
+
+// Writes a quoted JSON string, replacing invalid UTF-8 with U+FFFD.
+void writeJsonString(std::string &, std::string_view);
+// Writes the messages as an array.
+void writeJsonFrame(std::string &, const MessageBatch &);
+// Writes {"sequence":...,"snapshot":...,"messages":[...]}.
+void writeJsonFrame(std::string &, FrameHeader, const MessageBatch &);
+void writeMessagePackFrame(std::string &, const MessageBatch &);
+// Writes [sequence, snapshot, [messages...]].
+void writeMessagePackFrame(std::string &, FrameHeader, const MessageBatch &);
+
+struct Command {
+  enum class Method {
+    unknown,
+    save,
+    reduce,
+    restore,
+    transfer,
+    allocate,
+    addTransaction,
+    removeTransaction,
+    verifyTransaction,
+    updateTransaction,
+    moveTransaction,
+    createAccount,
+    renameAccount,
+    removeAccount,
+    closeAccount
+  };
+
+  Method method{};
+  std::string accountName;
+  // move names the destination account here as well
+  std::string newAccountName;
+  // transfer and allocate carry their amount here as well
+  Transaction transaction{};
+  // Set when remove and verify name their transaction by ID rather than by
+  // value. Update and move need it.
+  std::optional<TransactionId> transactionId;
+};
+
+// The name a message gives the method, or "unknown".
+auto methodName(Command::Method) -> std::string_view;
+
+// Decodes a message sent by web/main.ts. Malformed messages decode as
+// Method::unknown.
+auto jsonCommand(std::string_view) -> Command;
+
+// Applies every command except save, which needs the caller's persistence.
+void apply(Budget &, const Command &);
+} // namespace sbash64::budget
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef SBASH64_BUDGET_QUEUE_HPP_
+#define SBASH64_BUDGET_QUEUE_HPP_
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace sbash64::budget {
+// Unbounded lock-free queue for any number of producers and one consumer
+// (Vyukov's intrusive MPSC queue). Producers never wait on each other or on
+// the consumer, and nothing waits on the queue: the consumer is scheduled by
+// whoever pushes, so a push costs no wake-up.
+template <typename T> class MpscQueue {
+public:
+  MpscQueue() : head{new Node}, tail{head.load(std::memory_order_relaxed)} {}
+
+  ~MpscQueue() {
+    while (tail != nullptr) {
+      auto *next{tail->next.load(std::memory_order_relaxed)};
+      delete tail;
+      tail = next;
+    }
+  }
+
+  MpscQueue(const MpscQueue &) = delete;
+  MpscQueue(MpscQueue &&) = delete;
+  auto operator=(const MpscQueue &) -> MpscQueue & = delete;
+  auto operator=(MpscQueue &&) -> MpscQueue & = delete;
+
+  void push(T value) {
+    auto *node{new Node{std::move(value)}};
+    head.exchange(node, std::memory_order_acq_rel)
+        ->next.store(node, std::memory_order_release);
+  }
+
+  // Only the consumer may call tryPop. A push that has swapped the head but
+  // not yet linked its node is popped by a later call.
+  auto tryPop() -> std::optional<T> {
+    auto *next{tail->next.load(std::memory_order_acquire)};
+    if (next == nullptr)
+      return std::nullopt;
+    delete tail;
+    tail = next;
+    return std::exchange(next->value, std::nullopt);
+  }
+
+private:
+  struct Node {
+    std::optional<T> value;
+    std::atomic<Node *> next{};
+  };
+
+  std::atomic<Node *> head;
+  Node *tail;
+};
+} // namespace sbash64::budget
+
+#endif
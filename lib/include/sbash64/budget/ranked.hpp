@@ -0,0 +1,145 @@
+#ifndef SBASH64_BUDGET_RANKED_HPP_
+#define SBASH64_BUDGET_RANKED_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace sbash64::budget {
+// Owns distinct values in order and tells where each one ranks in
+// logarithmic time, which a std::set only tells by walking from its begin.
+// A treap: a binary search tree by value that is kept balanced, as expected,
+// by also being a heap by random priority. Each node counts its subtree.
+template <typename T, typename Less = std::less<>> class RankedSet {
+  struct Node {
+    Node(std::unique_ptr<T> v, std::uint32_t p)
+        : value{std::move(v)}, priority{p} {}
+
+    std::unique_ptr<T> value;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+    std::size_t size{1};
+    std::uint32_t priority;
+  };
+
+public:
+  static constexpr std::size_t nodeBytes{sizeof(Node)};
+
+  // Returns the rank the value takes.
+  auto insert(std::unique_ptr<T> value) -> std::size_t {
+    auto [before, after]{split(std::move(root), *value)};
+    const auto rank{size(before)};
+    root = merge(merge(std::move(before), std::make_unique<Node>(
+                                              std::move(value), priority())),
+                 std::move(after));
+    return rank;
+  }
+
+  // Returns null when the value isn't here.
+  auto extract(const T &value) -> std::unique_ptr<T> {
+    return extract(root, value);
+  }
+
+  [[nodiscard]] auto rank(const T &value) const -> std::optional<std::size_t> {
+    std::size_t before{0};
+    for (const auto *node{root.get()}; node != nullptr;)
+      if (Less{}(value, *node->value))
+        node = node->left.get();
+      else if (Less{}(*node->value, value)) {
+        before += size(node->left) + 1;
+        node = node->right.get();
+      } else
+        return before + size(node->left);
+    return std::nullopt;
+  }
+
+  // Visits the values in order.
+  template <typename F> void forEach(F f) const { forEach(root.get(), f); }
+
+  [[nodiscard]] auto size() const -> std::size_t { return size(root); }
+
+private:
+  using Pair = std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>>;
+
+  static auto size(const std::unique_ptr<Node> &node) -> std::size_t {
+    return node ? node->size : 0;
+  }
+
+  static void resize(Node &node) {
+    node.size = size(node.left) + 1 + size(node.right);
+  }
+
+  // Into the nodes before value and the rest.
+  static auto split(std::unique_ptr<Node> node, const T &value) -> Pair {
+    if (!node)
+      return {};
+    if (Less{}(*node->value, value)) {
+      auto [before, after]{split(std::move(node->right), value)};
+      node->right = std::move(before);
+      resize(*node);
+      return {std::move(node), std::move(after)};
+    }
+    auto [before, after]{split(std::move(node->left), value)};
+    node->left = std::move(after);
+    resize(*node);
+    return {std::move(before), std::move(node)};
+  }
+
+  // Every node of before orders before every node of after.
+  static auto merge(std::unique_ptr<Node> before, std::unique_ptr<Node> after)
+      -> std::unique_ptr<Node> {
+    if (!before)
+      return after;
+    if (!after)
+      return before;
+    if (before->priority > after->priority) {
+      before->right = merge(std::move(before->right), std::move(after));
+      resize(*before);
+      return before;
+    }
+    after->left = merge(std::move(before), std::move(after->left));
+    resize(*after);
+    return after;
+  }
+
+  static auto extract(std::unique_ptr<Node> &node, const T &value)
+      -> std::unique_ptr<T> {
+    if (!node)
+      return nullptr;
+    if (!Less{}(value, *node->value) && !Less{}(*node->value, value)) {
+      auto extracted{std::move(node->value)};
+      node = merge(std::move(node->left), std::move(node->right));
+      return extracted;
+    }
+    auto extracted{
+        extract(Less{}(value, *node->value) ? node->left : node->right, value)};
+    if (extracted)
+      --node->size;
+    return extracted;
+  }
+
+  template <typename F> static void forEach(const Node *node, F &f) {
+    if (node == nullptr)
+      return;
+    forEach(node->left.get(), f);
+    f(*node->value);
+    forEach(node->right.get(), f);
+  }
+
+  // Xorshift: fixed, so the same inserts build the same tree.
+  auto priority() -> std::uint32_t {
+    state ^= state << 13U;
+    state ^= state >> 17U;
+    state ^= state << 5U;
+    return state;
+  }
+
+  std::unique_ptr<Node> root;
+  std::uint32_t state{2463534242U};
+};
+} // namespace sbash64::budget
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SBASH64_BUDGET_RECORDING_HPP_
+#define SBASH64_BUDGET_RECORDING_HPP_
+
+#include <chrono>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace sbash64::budget {
+// A recording of a session holds the budget file as it was loaded followed
+// by each inbound payload with the microseconds since the one before it.
+// Lengths and times are unsigned LEB128, so that a small payload costs only
+// a few bytes more than itself. Applying the payloads in order to the budget
+// repeats the session.
+class RecordingWriter {
+public:
+  RecordingWriter(std::ostream &, std::string_view budget);
+  // Times before the last one written are taken as equal to it.
+  void write(std::chrono::microseconds sinceStart, std::string_view payload);
+
+private:
+  std::ostream &stream;
+  std::chrono::microseconds last{};
+};
+
+struct RecordedPayload {
+  std::chrono::microseconds sinceStart;
+  std::string payload;
+};
+
+class RecordingReader {
+public:
+  explicit RecordingReader(std::istream &);
+  // Whether the stream begins a recording.
+  [[nodiscard]] auto valid() const -> bool;
+  [[nodiscard]] auto budget() const -> const std::string &;
+  // Nothing past the last payload, or past one cut short as by a crash.
+  auto next() -> std::optional<RecordedPayload>;
+
+private:
+  std::istream &stream;
+  std::string budget_;
+  std::chrono::microseconds last{};
+  bool valid_{};
+};
+} // namespace sbash64::budget
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SBASH64_BUDGET_TRACE_HPP_
+#define SBASH64_BUDGET_TRACE_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sbash64::budget {
+// A finished span. Its name outlives it, as a string literal does. Times are
+// since the tracer was made.
+struct TraceEvent {
+  std::string_view name;
+  std::string detail;
+  std::uint_least32_t thread;
+  int depth;
+  std::chrono::nanoseconds begin;
+  std::chrono::nanoseconds duration;
+};
+
+// Keeps the latest capacity spans of each thread in a ring of that thread's
+// own, so that threads ending spans never wait on each other. A span that
+// begins while another is open on the same thread is its child. When an
+// outermost span takes at least slowThreshold, it is written to the log
+// along with all of its descendants, one per line, indented by depth.
+class Tracer {
+public:
+  Tracer(std::size_t capacity, std::chrono::nanoseconds slowThreshold,
+         std::ostream &log);
+  ~Tracer();
+  Tracer(const Tracer &) = delete;
+  Tracer(Tracer &&) = delete;
+  auto operator=(const Tracer &) -> Tracer & = delete;
+  auto operator=(Tracer &&) -> Tracer & = delete;
+  // Every thread's, oldest first by when they ended.
+  [[nodiscard]] auto events() const -> std::vector<TraceEvent>;
+  [[nodiscard]] auto now() const -> std::chrono::nanoseconds;
+  void add(TraceEvent);
+
+private:
+  struct Ring;
+
+  auto ring() -> Ring &;
+
+  std::size_t capacity;
+  // Tells this tracer apart from an earlier one at the same address.
+  std::uint_least64_t id;
+  std::vector<std::unique_ptr<Ring>> rings;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::nanoseconds slowThreshold;
+  std::ostream &log;
+  mutable std::mutex ringsMutex;
+  std::mutex logMutex;
+};
+
+// Times the scope it lives in.
+class TraceSpan {
+public:
+  TraceSpan(Tracer &, std::string_view name, std::string detail = {});
+  ~TraceSpan();
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan(TraceSpan &&) = delete;
+  auto operator=(const TraceSpan &) -> TraceSpan & = delete;
+  auto operator=(TraceSpan &&) -> TraceSpan & = delete;
+
+private:
+  Tracer &tracer;
+  std::string_view name;
+  std::string detail;
+  std::chrono::nanoseconds begin;
+  int depth;
+};
+
+// Writes the trace event format read by chrome://tracing and Perfetto, each
+// span as a complete event with its detail as an argument.
+void writeChromeTrace(std::string &, const std::vector<TraceEvent> &);
+} // namespace sbash64::budget
+
+#endif
@@ -9,23 +9,33 @@
 namespace sbash64::budget {
 class ObservableTransactionInMemory : public ObservableTransaction {
 public:
+  ObservableTransactionInMemory() = default;
+  explicit ObservableTransactionInMemory(TransactionId);
   void attach(Observer &) override;
   void initialize(const Transaction &) override;
   auto verifies(const Transaction &) -> bool override;
+  void verify() override;
+  void update(const Transaction &) override;
   auto removes(const Transaction &) -> bool override;
   void save(TransactionSerialization &) override;
   auto amount() -> USD override;
   void remove() override;
   void archive() override;
   auto verified() -> bool override;
+  auto id() -> TransactionId override;
+  auto memory() -> TransactionMemory override;
 
   class Factory : public ObservableTransaction::Factory {
   public:
     auto make() -> std::shared_ptr<ObservableTransaction> override;
+
+  private:
+    TransactionId nextId{1};
   };
 
 private:
   ArchivableVerifiableTransaction archivableVerifiableTransaction;
+  TransactionId id_{};
   std::vector<std::reference_wrapper<Observer>> observers{};
 };
 } // namespace sbash64::budget
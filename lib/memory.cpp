@@ -0,0 +1,79 @@
+#include "memory.hpp"
+#include "protocol.hpp"
+
+#include <numeric>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+#define SBASH64_BUDGET_HAS_MALLINFO2
+#endif
+
+namespace sbash64::budget {
+auto total(const AccountMemoryReport &report) -> std::size_t {
+  return report.account.transactions + report.account.archivedTransactions +
+         report.account.descriptions + report.account.observers +
+         report.presenter.transactions + report.presenter.descriptions;
+}
+
+auto memoryReport(Account &incomeAccount, BudgetInMemory &budget,
+                  BudgetPresenter &presenter)
+    -> std::vector<AccountMemoryReport> {
+  const auto presenters{presenter.memory()};
+  const auto presenterMemory{[&presenters](std::string_view name) {
+    const auto found{presenters.find(name)};
+    return found == presenters.end() ? PresenterMemory{} : found->second;
+  }};
+  std::vector<AccountMemoryReport> reports;
+  reports.push_back({incomeAccountName, incomeAccount.memory(),
+                     presenterMemory(incomeAccountName)});
+  for (const auto &[name, memory] : budget.memory())
+    reports.push_back({name, memory, presenterMemory(name)});
+  return reports;
+}
+
+auto allocatorMemory() -> std::optional<AllocatorMemory> {
+#ifdef SBASH64_BUDGET_HAS_MALLINFO2
+  const auto info{mallinfo2()};
+  return AllocatorMemory{info.uordblks + info.hblkhd, info.fordblks};
+#else
+  return std::nullopt;
+#endif
+}
+
+static void appendField(std::string &out, std::string_view name,
+                        std::size_t value) {
+  out += ",\"";
+  out += name;
+  out += "\":";
+  out += std::to_string(value);
+}
+
+void writeMemoryReport(std::string &out,
+                       const std::vector<AccountMemoryReport> &reports) {
+  out += R"({"total":)";
+  out += std::to_string(std::accumulate(
+      reports.begin(), reports.end(), std::size_t{0},
+      [](std::size_t sum, const AccountMemoryReport &report) {
+        return sum + total(report);
+      }));
+  out += R"(,"accounts":[)";
+  auto first{true};
+  for (const auto &report : reports) {
+    if (!first)
+      out += ',';
+    first = false;
+    out += R"({"name":)";
+    writeJsonString(out, report.name);
+    appendField(out, "total", total(report));
+    appendField(out, "transactions", report.account.transactions);
+    appendField(out, "archivedTransactions",
+                report.account.archivedTransactions);
+    appendField(out, "descriptions", report.account.descriptions);
+    appendField(out, "observers", report.account.observers);
+    appendField(out, "presenterTransactions", report.presenter.transactions);
+    appendField(out, "presenterDescriptions", report.presenter.descriptions);
+    out += '}';
+  }
+  out += "]}";
+}
+} // namespace sbash64::budget
@@ -0,0 +1,130 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+namespace sbash64::budget {
+static constexpr auto subBucketBits{3};
+
+static auto bucket(std::uint_least64_t nanoseconds) -> std::size_t {
+  if (nanoseconds < 1U << subBucketBits)
+    return nanoseconds;
+  const auto exponent{std::bit_width(nanoseconds) - 1};
+  return (exponent - subBucketBits + 1) << subBucketBits |
+         (nanoseconds >> (exponent - subBucketBits) &
+          ((1U << subBucketBits) - 1));
+}
+
+static auto highestEquivalent(std::size_t bucket) -> std::uint_least64_t {
+  if (bucket < 1U << subBucketBits)
+    return bucket;
+  const auto shift{(bucket >> subBucketBits) - 1};
+  const auto subBucket{bucket & ((1U << subBucketBits) - 1)};
+  return (((1U << subBucketBits) + subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) {
+  const auto nanoseconds{std::max<std::int_least64_t>(duration.count(), 0)};
+  counts.at(std::min(bucket(static_cast<std::uint_least64_t>(nanoseconds)),
+                     counts.size() - 1))
+      .fetch_add(1, std::memory_order_relaxed);
+  sumNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_release);
+}
+
+auto LatencyHistogram::count() const -> std::uint_least64_t {
+  return count_.load(std::memory_order_acquire);
+}
+
+auto LatencyHistogram::sum() const -> std::chrono::nanoseconds {
+  return std::chrono::nanoseconds{
+      sumNanoseconds.load(std::memory_order_relaxed)};
+}
+
+auto LatencyHistogram::quantile(double q) const -> std::chrono::nanoseconds {
+  const auto total{count()};
+  if (total == 0)
+    return {};
+  const auto rank{std::max<std::uint_least64_t>(
+      static_cast<std::uint_least64_t>(
+          std::ceil(q * static_cast<double>(total))),
+      1)};
+  std::uint_least64_t seen{0};
+  std::size_t last{0};
+  for (std::size_t i{0}; i < counts.size(); ++i) {
+    const auto n{counts.at(i).load(std::memory_order_relaxed)};
+    if (n == 0)
+      continue;
+    last = i;
+    seen += n;
+    if (seen >= rank)
+      break;
+  }
+  return std::chrono::nanoseconds{highestEquivalent(last)};
+}
+
+static void append(std::string &out, double value) {
+  std::array<char, 32> digits{};
+  const auto [end, error]{
+      std::to_chars(digits.data(), digits.data() + digits.size(), value)};
+  out.append(digits.data(), end);
+}
+
+static void appendName(std::string &out, std::string_view name,
+                       std::string_view labels,
+                       std::string_view extraLabel = {}) {
+  out += name;
+  if (labels.empty() && extraLabel.empty())
+    return;
+  out += '{';
+  out += labels;
+  if (!labels.empty() && !extraLabel.empty())
+    out += ',';
+  out += extraLabel;
+  out += '}';
+}
+
+void writePrometheusHeader(std::string &out, std::string_view name,
+                           std::string_view type, std::string_view help) {
+  out += "# HELP ";
+  out += name;
+  out += ' ';
+  out += help;
+  out += "\n# TYPE ";
+  out += name;
+  out += ' ';
+  out += type;
+  out += '\n';
+}
+
+void writePrometheusSample(std::string &out, std::string_view name,
+                           std::string_view labels, double value) {
+  appendName(out, name, labels);
+  out += ' ';
+  append(out, value);
+  out += '\n';
+}
+
+void writePrometheusSummary(std::string &out, std::string_view name,
+                            std::string_view labels,
+                            const LatencyHistogram &histogram) {
+  for (const auto &[q, label] :
+       {std::pair{.5, R"(quantile="0.5")"},
+        std::pair{.9, R"(quantile="0.9")"},
+        std::pair{.99, R"(quantile="0.99")"},
+        std::pair{.999, R"(quantile="0.999")"}}) {
+    appendName(out, name, labels, label);
+    out += ' ';
+    append(out, std::chrono::duration<double>{histogram.quantile(q)}.count());
+    out += '\n';
+  }
+  writePrometheusSample(
+      out, std::string{name} + "_sum", labels,
+      std::chrono::duration<double>{histogram.sum()}.count());
+  writePrometheusSample(out, std::string{name} + "_count", labels,
+                        static_cast<double>(histogram.count()));
+}
+} // namespace sbash64::budget
@@ -1,27 +1,60 @@
 #include "parse.hpp"
 
+#include <charconv>
 #include <cstdint>
-#include <sstream>
 #include <string>
+#include <system_error>
 
 namespace sbash64::budget {
+static auto isSpace(char c) -> bool {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+static auto skipSpace(std::string_view s, std::string_view::size_type i)
+    -> std::string_view::size_type {
+  while (i < s.size() && isSpace(s[i]))
+    ++i;
+  return i;
+}
+
+// Reads an integer the way operator>> does: after any whitespace and with an
+// optional sign.
+static auto integer(std::string_view s, std::string_view::size_type &i,
+                    std::int_least64_t &value) -> bool {
+  i = skipSpace(s, i);
+  if (i < s.size() && s[i] == '+' && (i + 1 == s.size() || s[i + 1] != '-'))
+    ++i;
+  const auto [end, error]{
+      std::from_chars(s.data() + i, s.data() + s.size(), value)};
+  if (error != std::errc{})
+    return false;
+  i = end - s.data();
+  return true;
+}
+
 auto usd(std::string_view s) -> USD {
   USD usd{};
-  std::stringstream stream;
-  stream << s;
-  if (stream.peek() != '.' && stream.peek() != '-') {
+  std::string_view::size_type i{0};
+  if (s.empty())
+    return usd;
+  if (s.front() != '.' && s.front() != '-') {
     std::int_least64_t dollars = 0;
-    stream >> dollars;
+    if (!integer(s, i, dollars))
+      return usd;
     usd.cents = dollars * 100;
   }
-  if (stream.get() == '.' && stream.peek() != '-') {
-    std::string afterDecimal;
-    stream >> afterDecimal;
+  if (i < s.size() && s[i] == '.' && (i + 1 == s.size() || s[i + 1] != '-')) {
+    const auto begin{skipSpace(s, i + 1)};
+    auto end{begin};
+    while (end < s.size() && !isSpace(s[end]))
+      ++end;
+    std::string afterDecimal{s.substr(begin, end - begin)};
     afterDecimal.resize(2, '0');
-    std::istringstream streamAfterDecimal{afterDecimal};
+    std::string_view::size_type j{0};
     std::int_least64_t cents = 0;
-    streamAfterDecimal >> cents;
-    usd.cents += cents;
+    if (integer(afterDecimal, j, cents))
+      usd.cents += cents;
   }
   return usd;
 }
@@ -1,10 +1,9 @@
 #include "presentation.hpp"
 #include "domain.hpp"
-#include "format.hpp"
+#include "memory.hpp"
 
 #include <algorithm>
 #include <iterator>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 
@@ -12,55 +11,50 @@ namespace sbash64::budget {
 TransactionPresenter::TransactionPresenter(ObservableTransaction &transaction,
                                            const std::set<View *> &views,
                                            AccountPresenter &parent)
-    : views{views}, parent{parent} {
+    : id_{transaction.id()}, views{views}, parent{&parent} {
   transaction.attach(*this);
 }
 
 void TransactionPresenter::notifyThatIsVerified() {
   verified = true;
   for (const auto &view : views)
-    view->putCheckmarkNextToTransactionRow(parent.parent.index(&parent),
-                                           parent.index(this));
+    view->putCheckmarkNextToTransactionRow(parent->parent.index(parent),
+                                           parent->index(this));
 }
 
 void TransactionPresenter::notifyThatIsArchived() {
   archived = true;
   for (const auto &view : views)
-    view->removeTransactionRowSelection(parent.parent.index(&parent),
-                                        parent.index(this));
-}
-
-static auto format(USD usd) -> std::string {
-  std::stringstream stream;
-  stream << usd;
-  return stream.str();
-}
-
-static auto date(const Transaction &t) -> std::string {
-  std::stringstream stream;
-  stream << t.date;
-  return stream.str();
+    view->removeTransactionRowSelection(parent->parent.index(parent),
+                                        parent->index(this));
 }
 
 void TransactionPresenter::notifyThatIs(const Transaction &t) {
+  if (ordered) {
+    parent->reorder(this, t);
+    return;
+  }
   transaction = t;
-  parent.ready(this);
+  parent->ready(this);
+  ordered = true;
 }
 
 void TransactionPresenter::notifyThatWillBeRemoved() {
   for (const auto &view : views)
-    view->deleteTransactionRow(parent.parent.index(&parent),
-                               parent.index(this));
-  parent.remove(this);
+    view->deleteTransactionRow(parent->parent.index(parent),
+                               parent->index(this));
+  parent->remove(this);
 }
 
-void TransactionPresenter::catchUp(View *view) {
+void TransactionPresenter::reparent(AccountPresenter &to) { parent = &to; }
+
+void TransactionPresenter::catchUp(View *view, gsl::index transactionIndex) {
   if (verified)
-    view->putCheckmarkNextToTransactionRow(parent.parent.index(&parent),
-                                           parent.index(this));
+    view->putCheckmarkNextToTransactionRow(parent->parent.index(parent),
+                                           transactionIndex);
   if (archived)
-    view->removeTransactionRowSelection(parent.parent.index(&parent),
-                                        parent.index(this));
+    view->removeTransactionRowSelection(parent->parent.index(parent),
+                                        transactionIndex);
 }
 
 static auto operator<(const TransactionPresenter &a,
@@ -74,27 +68,14 @@ static auto operator<(const TransactionPresenter &a,
   return &a < &b;
 }
 
-static auto operator<(const std::unique_ptr<TransactionPresenter> &a,
-                      const std::unique_ptr<TransactionPresenter> &b) -> bool {
-  return *a < *b;
-}
-
-static auto operator<(const std::unique_ptr<TransactionPresenter> &a,
-                      const TransactionPresenter &b) -> bool {
-  return *a < b;
-}
-
-static auto operator<(const TransactionPresenter &a,
-                      const std::unique_ptr<TransactionPresenter> &b) -> bool {
-  return a < *b;
+auto TransactionRowOrder::operator()(const TransactionPresenter &a,
+                                     const TransactionPresenter &b) const
+    -> bool {
+  return a < b;
 }
 
-static auto transactionIndex(
-    const std::set<std::unique_ptr<TransactionPresenter>, std::less<>>
-        &orderedChildren,
-    std::set<std::unique_ptr<TransactionPresenter>>::const_iterator it)
-    -> gsl::index {
-  return std::distance(orderedChildren.begin(), it);
+static auto rowIndex(std::size_t rank) -> gsl::index {
+  return static_cast<gsl::index>(rank);
 }
 
 AccountPresenter::AccountPresenter(Account &account,
@@ -113,13 +94,13 @@ void AccountPresenter::notifyThatNameHasChanged(std::string_view name) {
 void AccountPresenter::notifyThatBalanceHasChanged(USD usd) {
   balance = usd;
   for (const auto &view : views)
-    view->updateAccountBalance(parent.index(this), format(usd));
+    view->updateAccountBalance(parent.index(this), usd);
 }
 
 void AccountPresenter::notifyThatAllocationHasChanged(USD usd) {
   allocation = usd;
   for (const auto &view : views)
-    view->updateAccountAllocation(parent.index(this), format(usd));
+    view->updateAccountAllocation(parent.index(this), usd);
 }
 
 void AccountPresenter::notifyThatHasBeenAdded(ObservableTransaction &t) {
@@ -135,22 +116,53 @@ void AccountPresenter::ready(const TransactionPresenter *child) {
               })};
   if (unorderedChild == unorderedChildren.end())
     throw std::runtime_error{"Unable to find transaction presenter"};
-  const auto [it, success]{orderedChildren.insert(std::move(*unorderedChild))};
-  if (!success)
-    throw std::runtime_error{"Unable to insert transaction presenter"};
+  auto ordered{std::move(*unorderedChild)};
   unorderedChildren.erase(unorderedChild);
+  orderedChildrenById.emplace(child->id(), child);
+  const auto transactionIndex{
+      rowIndex(orderedChildren.insert(std::move(ordered)))};
   for (const auto &view : views)
-    view->addTransactionRow(parent.index(this), format(child->get().amount),
-                            date(child->get()), child->get().description,
-                            transactionIndex(orderedChildren, it));
+    view->addTransactionRow(parent.index(this), child->get().amount,
+                            child->get().date, child->get().description,
+                            transactionIndex, child->id());
 }
 
 void AccountPresenter::remove(const TransactionPresenter *child) {
-  const auto it = orderedChildren.find(*child);
-  if (it == orderedChildren.end())
+  orderedChildrenById.erase(child->id());
+  if (!orderedChildren.extract(*child))
     throw std::runtime_error{
         "Unable to find transaction presenter for removal"};
-  orderedChildren.erase(it);
+}
+
+void AccountPresenter::reorder(const TransactionPresenter *child,
+                               const Transaction &transaction) {
+  const auto from{orderedChildren.rank(*child)};
+  if (!from)
+    throw std::runtime_error{
+        "Unable to find transaction presenter for reordering"};
+  auto extracted{orderedChildren.extract(*child)};
+  extracted->set(transaction);
+  const auto toIndex{rowIndex(orderedChildren.insert(std::move(extracted)))};
+  for (const auto &view : views)
+    view->updateTransactionRow(parent.index(this), rowIndex(*from), toIndex,
+                               transaction.amount, transaction.date,
+                               transaction.description);
+}
+
+void AccountPresenter::move(TransactionId id, AccountPresenter &to) {
+  const auto found{orderedChildrenById.find(id)};
+  if (found == orderedChildrenById.end())
+    throw std::runtime_error{"Unable to find transaction presenter for moving"};
+  const auto *const child{found->second};
+  orderedChildrenById.erase(found);
+  const auto fromIndex{rowIndex(orderedChildren.rank(*child).value())};
+  auto moved{orderedChildren.extract(*child)};
+  moved->reparent(to);
+  to.orderedChildrenById.emplace(id, child);
+  const auto toIndex{rowIndex(to.orderedChildren.insert(std::move(moved)))};
+  for (const auto &view : views)
+    view->moveTransactionRow(parent.index(this), fromIndex, parent.index(&to),
+                             toIndex);
 }
 
 void AccountPresenter::notifyThatWillBeRemoved() {
@@ -159,19 +171,39 @@ void AccountPresenter::notifyThatWillBeRemoved() {
   parent.remove(this);
 }
 
+// Rows are numbered as they are visited rather than looked up one by one.
 void AccountPresenter::catchUp(View *view) {
-  view->updateAccountBalance(parent.index(this), format(balance));
-  view->updateAccountAllocation(parent.index(this), format(allocation));
-  for (const auto &child : orderedChildren) {
-    view->addTransactionRow(parent.index(this), format(child->get().amount),
-                            date(child->get()), child->get().description,
-                            index(child.get()));
-    child->catchUp(view);
-  }
+  const auto accountIndex{parent.index(this)};
+  view->updateAccountBalance(accountIndex, balance);
+  view->updateAccountAllocation(accountIndex, allocation);
+  gsl::index transactionIndex{0};
+  orderedChildren.forEach([&](TransactionPresenter &child) {
+    view->addTransactionRow(accountIndex, child.get().amount, child.get().date,
+                            child.get().description, transactionIndex,
+                            child.id());
+    child.catchUp(view, transactionIndex);
+    ++transactionIndex;
+  });
 }
 
 auto AccountPresenter::index(const TransactionPresenter *child) -> gsl::index {
-  return transactionIndex(orderedChildren, orderedChildren.find(*child));
+  return rowIndex(
+      orderedChildren.rank(*child).value_or(orderedChildren.size()));
+}
+
+auto AccountPresenter::memory() const -> PresenterMemory {
+  PresenterMemory memory{heapBytes(unorderedChildren) +
+                             heapBytes(orderedChildren) +
+                             heapBytes(orderedChildrenById) + heapBytes(name),
+                         0};
+  const auto add{[&memory](const TransactionPresenter &child) {
+    memory.transactions += sizeof child;
+    memory.descriptions += heapBytes(child.get().description);
+  }};
+  for (const auto &child : unorderedChildren)
+    add(*child);
+  orderedChildren.forEach(add);
+  return memory;
 }
 
 static auto operator<(const AccountPresenter &a, const AccountPresenter &b)
@@ -196,6 +228,16 @@ static auto operator<(const AccountPresenter &a,
   return a < *b;
 }
 
+static auto operator<(const std::unique_ptr<AccountPresenter> &a,
+                      std::string_view name) -> bool {
+  return a->name < name;
+}
+
+static auto operator<(std::string_view name,
+                      const std::unique_ptr<AccountPresenter> &b) -> bool {
+  return name < b->name;
+}
+
 static auto
 accountIndex(const std::set<std::unique_ptr<AccountPresenter>, std::less<>>
                  &orderedChildren,
@@ -220,7 +262,7 @@ void BudgetPresenter::notifyThatExpenseAccountHasBeenCreated(
 void BudgetPresenter::notifyThatNetIncomeHasChanged(USD usd) {
   netIncome = usd;
   for (const auto &view : views)
-    view->updateNetIncome(format(usd));
+    view->updateNetIncome(usd);
 }
 
 void BudgetPresenter::remove(const AccountPresenter *child) {
@@ -244,6 +286,21 @@ void BudgetPresenter::reorder(const AccountPresenter *child,
     view->reorderAccountIndex(fromIndex, toIndex);
 }
 
+static auto
+named(const std::set<std::unique_ptr<AccountPresenter>, std::less<>> &accounts,
+      std::string_view name) -> AccountPresenter & {
+  const auto it{accounts.find(name)};
+  if (it == accounts.end())
+    throw std::runtime_error{"Unable to find account presenter by name"};
+  return **it;
+}
+
+void BudgetPresenter::notifyThatExpenseHasMoved(std::string_view from,
+                                                std::string_view to,
+                                                TransactionId id) {
+  named(accounts, from).move(id, named(accounts, to));
+}
+
 void BudgetPresenter::notifyThatHasBeenSaved() {
   for (const auto &view : views)
     view->markAsSaved();
@@ -255,18 +312,33 @@ void BudgetPresenter::notifyThatHasUnsavedChanges() {
 }
 
 void BudgetPresenter::add(View *view) {
-  view->updateNetIncome(format(netIncome));
+  catchUp(view);
+  attach(view);
+}
+
+void BudgetPresenter::attach(View *view) { views.insert(view); }
+
+void BudgetPresenter::catchUp(View *view) {
+  view->updateNetIncome(netIncome);
   view->addNewAccountTable(incomeAccountName, 0);
   incomeAccount.catchUp(view);
   for (const auto &account : accounts) {
     view->addNewAccountTable(account->name, index(account.get()));
     account->catchUp(view);
   }
-  views.insert(view);
 }
 
 void BudgetPresenter::remove(View *view) { views.erase(view); }
 
+auto BudgetPresenter::memory() const
+    -> std::map<std::string, PresenterMemory, std::less<>> {
+  std::map<std::string, PresenterMemory, std::less<>> memory;
+  memory.emplace(incomeAccount.name, incomeAccount.memory());
+  for (const auto &account : accounts)
+    memory.emplace(account->name, account->memory());
+  return memory;
+}
+
 auto BudgetPresenter::index(const AccountPresenter *account) -> gsl::index {
   if (account == &incomeAccount)
     return 0;
@@ -0,0 +1,987 @@
+#include "protocol.hpp"
+#include "parse.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <utility>
+
+namespace sbash64::budget {
+void MessageBatch::supersede(std::optional<std::size_t> &latest) {
+  if (latest) {
+    auto &message{messages_.at(*latest)};
+    message.superseded = true;
+    size_ -= message.size;
+  }
+  latest = messages_.size();
+}
+
+auto MessageBatch::begin(MessageKind kind, gsl::index accountIndex)
+    -> std::string & {
+  switch (kind) {
+  case MessageKind::accountIndexChange:
+    latestAccountAllocations.clear();
+    latestAccountBalances.clear();
+    break;
+  case MessageKind::accountAllocation:
+    supersede(latestAccountAllocations[accountIndex]);
+    break;
+  case MessageKind::accountBalance:
+    supersede(latestAccountBalances[accountIndex]);
+    break;
+  case MessageKind::netIncome:
+    supersede(latestNetIncome);
+    break;
+  case MessageKind::savedState:
+    supersede(latestSavedState);
+    break;
+  case MessageKind::other:
+    break;
+  }
+  messages_.push_back({buffer.size(), 0, kind, accountIndex, false});
+  return buffer;
+}
+
+void MessageBatch::end() {
+  messages_.back().size = buffer.size() - messages_.back().offset;
+  size_ += messages_.back().size;
+}
+
+void MessageBatch::append(const MessageBatch &other) {
+  for (const auto &message : other.messages_)
+    if (!message.superseded) {
+      begin(message.kind, message.accountIndex)
+          .append(other.buffer, message.offset, message.size);
+      end();
+    }
+  if (buffer.size() > 2 * size_) {
+    MessageBatch compacted;
+    compacted.append(*this);
+    *this = std::move(compacted);
+  }
+}
+
+auto MessageBatch::messages() const -> std::vector<std::string_view> {
+  std::vector<std::string_view> collected;
+  collected.reserve(messages_.size());
+  for (const auto &message : messages_)
+    if (!message.superseded)
+      collected.emplace_back(buffer.data() + message.offset, message.size);
+  return collected;
+}
+
+auto MessageBatch::empty() const -> bool { return messages_.empty(); }
+
+auto MessageBatch::size() const -> std::string::size_type { return size_; }
+
+void MessageBatch::clear() {
+  buffer.clear();
+  size_ = 0;
+  messages_.clear();
+  latestAccountAllocations.clear();
+  latestAccountBalances.clear();
+  latestNetIncome.reset();
+  latestSavedState.reset();
+}
+
+static auto isContinuation(unsigned char c) -> bool {
+  return (c & 0xC0U) == 0x80U;
+}
+
+// Length of the well-formed UTF-8 sequence starting at i, or zero.
+static auto utf8SequenceLength(std::string_view s,
+                               std::string_view::size_type i)
+    -> std::string_view::size_type {
+  const auto lead{static_cast<unsigned char>(s[i])};
+  std::string_view::size_type length = 0;
+  if (lead >= 0xC2U && lead <= 0xDFU)
+    length = 2;
+  else if (lead >= 0xE0U && lead <= 0xEFU)
+    length = 3;
+  else if (lead >= 0xF0U && lead <= 0xF4U)
+    length = 4;
+  if (length == 0 || i + length > s.size())
+    return 0;
+  for (std::string_view::size_type j{1}; j < length; ++j)
+    if (!isContinuation(static_cast<unsigned char>(s[i + j])))
+      return 0;
+  return length;
+}
+
+static void appendEscaped(std::string &out, unsigned char c) {
+  constexpr std::array<char, 16> hex{'0', '1', '2', '3', '4', '5', '6', '7',
+                                     '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+  switch (c) {
+  case '"':
+    out += "\\\"";
+    break;
+  case '\\':
+    out += "\\\\";
+    break;
+  case '\b':
+    out += "\\b";
+    break;
+  case '\f':
+    out += "\\f";
+    break;
+  case '\n':
+    out += "\\n";
+    break;
+  case '\r':
+    out += "\\r";
+    break;
+  case '\t':
+    out += "\\t";
+    break;
+  default:
+    out += "\\u00";
+    out += hex.at(c >> 4U);
+    out += hex.at(c & 0xFU);
+  }
+}
+
+static void appendString(std::string &out, std::string_view s) {
+  out += '"';
+  std::string_view::size_type unescaped{0};
+  std::string_view::size_type i{0};
+  while (i < s.size()) {
+    const auto c{static_cast<unsigned char>(s[i])};
+    if (c >= 0x20U && c < 0x80U && c != '"' && c != '\\') {
+      ++i;
+      continue;
+    }
+    if (c >= 0x80U) {
+      if (const auto length{utf8SequenceLength(s, i)}; length != 0) {
+        i += length;
+        continue;
+      }
+    }
+    out.append(s.substr(unescaped, i - unescaped));
+    if (c >= 0x80U)
+      out += "\\ufffd";
+    else
+      appendEscaped(out, c);
+    unescaped = ++i;
+  }
+  out.append(s.substr(unescaped));
+  out += '"';
+}
+
+static void appendInteger(std::string &out, gsl::index i) {
+  std::array<char, 24> digits{};
+  const auto [end, error]{
+      std::to_chars(digits.data(), digits.data() + digits.size(), i)};
+  out.append(digits.data(), end);
+}
+
+static auto beginMessage(MessageBatch &batch, std::string_view method,
+                         MessageKind kind = MessageKind::other,
+                         gsl::index accountIndex = 0) -> std::string & {
+  auto &out{batch.begin(kind, accountIndex)};
+  out += R"({"method":")";
+  out += method;
+  out += '"';
+  return out;
+}
+
+static void endMessage(MessageBatch &batch, std::string &out) {
+  out += '}';
+  batch.end();
+}
+
+static void appendKey(std::string &out, std::string_view key) {
+  out += ",\"";
+  out += key;
+  out += "\":";
+}
+
+static void appendField(std::string &out, std::string_view key,
+                        gsl::index value) {
+  appendKey(out, key);
+  appendInteger(out, value);
+}
+
+static void appendField(std::string &out, std::string_view key,
+                        std::string_view value) {
+  appendKey(out, key);
+  appendString(out, value);
+}
+
+static void appendTwoDigits(std::string &out, std::int_least64_t value) {
+  out += static_cast<char>('0' + value / 10);
+  out += static_cast<char>('0' + value % 10);
+}
+
+// Formats like operator<<(std::ostream &, USD).
+static void appendField(std::string &out, std::string_view key, USD value) {
+  appendKey(out, key);
+  out += '"';
+  if (value.cents < 0)
+    out += '-';
+  appendInteger(out, std::abs(value.cents / 100));
+  out += '.';
+  appendTwoDigits(out, std::abs(value.cents % 100));
+  out += '"';
+}
+
+// Formats like operator<<(std::ostream &, const Date &).
+static void appendField(std::string &out, std::string_view key,
+                        const Date &value) {
+  appendKey(out, key);
+  out += '"';
+  appendTwoDigits(out, static_cast<int>(value.month));
+  out += '/';
+  appendTwoDigits(out, value.day);
+  out += '/';
+  appendInteger(out, value.year);
+  out += '"';
+}
+
+JsonView::JsonView(MessageBatch &batch) : batch{batch} {}
+
+void JsonView::setAccountName(gsl::index accountIndex, std::string_view name) {
+  auto &out{beginMessage(batch, "update account name")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "name", name);
+  endMessage(batch, out);
+}
+
+void JsonView::reorderAccountIndex(gsl::index from, gsl::index to) {
+  auto &out{beginMessage(batch, "reorder account",
+                         MessageKind::accountIndexChange)};
+  appendField(out, "accountIndex", from);
+  appendField(out, "newIndex", to);
+  endMessage(batch, out);
+}
+
+void JsonView::updateAccountAllocation(gsl::index accountIndex, USD amount) {
+  auto &out{beginMessage(batch, "update account allocation",
+                         MessageKind::accountAllocation, accountIndex)};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "amount", amount);
+  endMessage(batch, out);
+}
+
+void JsonView::updateAccountBalance(gsl::index accountIndex, USD amount) {
+  auto &out{beginMessage(batch, "update account balance",
+                         MessageKind::accountBalance, accountIndex)};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "amount", amount);
+  endMessage(batch, out);
+}
+
+void JsonView::putCheckmarkNextToTransactionRow(gsl::index accountIndex,
+                                                gsl::index transactionIndex) {
+  auto &out{beginMessage(batch, "check transaction row")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "transactionIndex", transactionIndex);
+  endMessage(batch, out);
+}
+
+void JsonView::deleteTransactionRow(gsl::index accountIndex,
+                                    gsl::index transactionIndex) {
+  auto &out{beginMessage(batch, "delete transaction row")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "transactionIndex", transactionIndex);
+  endMessage(batch, out);
+}
+
+void JsonView::updateTransactionRow(gsl::index accountIndex,
+                                    gsl::index transactionIndex,
+                                    gsl::index newTransactionIndex, USD amount,
+                                    const Date &date,
+                                    std::string_view description) {
+  auto &out{beginMessage(batch, "update transaction row")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "transactionIndex", transactionIndex);
+  appendField(out, "newIndex", newTransactionIndex);
+  appendField(out, "description", description);
+  appendField(out, "amount", amount);
+  appendField(out, "date", date);
+  endMessage(batch, out);
+}
+
+void JsonView::moveTransactionRow(gsl::index accountIndex,
+                                  gsl::index transactionIndex,
+                                  gsl::index newAccountIndex,
+                                  gsl::index newTransactionIndex) {
+  auto &out{beginMessage(batch, "move transaction row")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "transactionIndex", transactionIndex);
+  appendField(out, "newAccountIndex", newAccountIndex);
+  appendField(out, "newIndex", newTransactionIndex);
+  endMessage(batch, out);
+}
+
+void JsonView::addTransactionRow(gsl::index accountIndex, USD amount,
+                                 const Date &date, std::string_view description,
+                                 gsl::index transactionIndex,
+                                 TransactionId id) {
+  auto &out{beginMessage(batch, "add transaction row")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "transactionIndex", transactionIndex);
+  appendField(out, "transactionId", static_cast<gsl::index>(id));
+  appendField(out, "description", description);
+  appendField(out, "amount", amount);
+  appendField(out, "date", date);
+  endMessage(batch, out);
+}
+
+void JsonView::removeTransactionRowSelection(gsl::index accountIndex,
+                                             gsl::index transactionIndex) {
+  auto &out{beginMessage(batch, "remove transaction row selection")};
+  appendField(out, "accountIndex", accountIndex);
+  appendField(out, "transactionIndex", transactionIndex);
+  endMessage(batch, out);
+}
+
+void JsonView::addNewAccountTable(std::string_view name,
+                                  gsl::index accountIndex) {
+  auto &out{beginMessage(batch, "add account table",
+                         MessageKind::accountIndexChange)};
+  appendField(out, "name", name);
+  appendField(out, "accountIndex", accountIndex);
+  endMessage(batch, out);
+}
+
+void JsonView::deleteAccountTable(gsl::index accountIndex) {
+  auto &out{beginMessage(batch, "delete account table",
+                         MessageKind::accountIndexChange)};
+  appendField(out, "accountIndex", accountIndex);
+  endMessage(batch, out);
+}
+
+void JsonView::updateNetIncome(USD amount) {
+  auto &out{
+      beginMessage(batch, "update net income", MessageKind::netIncome)};
+  appendField(out, "amount", amount);
+  endMessage(batch, out);
+}
+
+void JsonView::markAsSaved() {
+  auto &out{beginMessage(batch, "mark as saved", MessageKind::savedState)};
+  endMessage(batch, out);
+}
+
+void JsonView::markAsUnsaved() {
+  auto &out{beginMessage(batch, "mark as unsaved", MessageKind::savedState)};
+  endMessage(batch, out);
+}
+
+void writeJsonString(std::string &out, std::string_view s) {
+  appendString(out, s);
+}
+
+void writeJsonFrame(std::string &frame, FrameHeader header,
+                    const MessageBatch &batch) {
+  frame += R"({"sequence":)";
+  appendInteger(frame, static_cast<gsl::index>(header.sequence));
+  frame += header.snapshot ? R"(,"snapshot":true)" : R"(,"snapshot":false)";
+  frame += R"(,"messages":)";
+  writeJsonFrame(frame, batch);
+  frame += '}';
+}
+
+void writeJsonFrame(std::string &frame, const MessageBatch &batch) {
+  frame += '[';
+  auto first{true};
+  for (const auto message : batch.messages()) {
+    if (!first)
+      frame += ',';
+    frame += message;
+    first = false;
+  }
+  frame += ']';
+}
+
+static void appendBigEndian(std::string &out, unsigned char marker,
+                            std::uint_least64_t value, int bytes) {
+  out += static_cast<char>(marker);
+  for (auto shift{8 * (bytes - 1)}; shift >= 0; shift -= 8)
+    out += static_cast<char>((value >> static_cast<unsigned>(shift)) & 0xFFU);
+}
+
+static void appendMessagePack(std::string &out, std::int_least64_t value) {
+  const auto bits{static_cast<std::uint_least64_t>(value)};
+  if (value >= 0 && value < 0x80)
+    out += static_cast<char>(value);
+  else if (value < 0 && value >= -32)
+    out += static_cast<char>(bits & 0xFFU);
+  else if (value >= 0 && value <= 0xFF)
+    appendBigEndian(out, 0xCCU, bits, 1);
+  else if (value >= 0 && value <= 0xFFFF)
+    appendBigEndian(out, 0xCDU, bits, 2);
+  else if (value >= 0 && value <= 0xFFFFFFFF)
+    appendBigEndian(out, 0xCEU, bits, 4);
+  else if (value >= -0x80 && value < 0)
+    appendBigEndian(out, 0xD0U, bits, 1);
+  else if (value >= -0x8000 && value < 0)
+    appendBigEndian(out, 0xD1U, bits, 2);
+  else if (value >= -0x80000000LL && value < 0)
+    appendBigEndian(out, 0xD2U, bits, 4);
+  else
+    appendBigEndian(out, 0xD3U, bits, 8);
+}
+
+static void appendMessagePack(std::string &out, std::string_view value) {
+  if (value.size() < 32)
+    out += static_cast<char>(0xA0U | value.size());
+  else if (value.size() <= 0xFF)
+    appendBigEndian(out, 0xD9U, value.size(), 1);
+  else if (value.size() <= 0xFFFF)
+    appendBigEndian(out, 0xDAU, value.size(), 2);
+  else
+    appendBigEndian(out, 0xDBU, value.size(), 4);
+  out += value;
+}
+
+static void appendMessagePack(std::string &out, USD value) {
+  appendMessagePack(out, value.cents);
+}
+
+static void appendMessagePack(std::string &out, const Date &value) {
+  appendMessagePack(out, value.year * 10000LL +
+                             static_cast<int>(value.month) * 100LL +
+                             value.day);
+}
+
+static void appendMessagePackArrayHeader(std::string &out, std::size_t size) {
+  if (size < 16)
+    out += static_cast<char>(0x90U | size);
+  else if (size <= 0xFFFF)
+    appendBigEndian(out, 0xDCU, size, 2);
+  else
+    appendBigEndian(out, 0xDDU, size, 4);
+}
+
+template <typename... Fields>
+static void writeMessagePack(MessageBatch &batch, MessageKind kind,
+                             gsl::index accountIndex, MessagePackMethod method,
+                             const Fields &...fields) {
+  auto &out{batch.begin(kind, accountIndex)};
+  appendMessagePackArrayHeader(out, 1 + sizeof...(Fields));
+  appendMessagePack(out, static_cast<std::int_least64_t>(method));
+  (appendMessagePack(out, fields), ...);
+  batch.end();
+}
+
+template <typename... Fields>
+static void writeMessagePack(MessageBatch &batch, MessagePackMethod method,
+                             const Fields &...fields) {
+  writeMessagePack(batch, MessageKind::other, 0, method, fields...);
+}
+
+MessagePackView::MessagePackView(MessageBatch &batch) : batch{batch} {}
+
+void MessagePackView::setAccountName(gsl::index accountIndex,
+                                     std::string_view name) {
+  writeMessagePack(batch, MessagePackMethod::updateAccountName, accountIndex,
+                   name);
+}
+
+void MessagePackView::reorderAccountIndex(gsl::index from, gsl::index to) {
+  writeMessagePack(batch, MessageKind::accountIndexChange, 0,
+                   MessagePackMethod::reorderAccount, from, to);
+}
+
+void MessagePackView::updateAccountAllocation(gsl::index accountIndex,
+                                              USD amount) {
+  writeMessagePack(batch, MessageKind::accountAllocation, accountIndex,
+                   MessagePackMethod::updateAccountAllocation, accountIndex,
+                   amount);
+}
+
+void MessagePackView::updateAccountBalance(gsl::index accountIndex,
+                                           USD amount) {
+  writeMessagePack(batch, MessageKind::accountBalance, accountIndex,
+                   MessagePackMethod::updateAccountBalance, accountIndex,
+                   amount);
+}
+
+void MessagePackView::putCheckmarkNextToTransactionRow(
+    gsl::index accountIndex, gsl::index transactionIndex) {
+  writeMessagePack(batch, MessagePackMethod::checkTransactionRow, accountIndex,
+                   transactionIndex);
+}
+
+void MessagePackView::deleteTransactionRow(gsl::index accountIndex,
+                                           gsl::index transactionIndex) {
+  writeMessagePack(batch, MessagePackMethod::deleteTransactionRow,
+                   accountIndex, transactionIndex);
+}
+
+void MessagePackView::updateTransactionRow(gsl::index accountIndex,
+                                           gsl::index transactionIndex,
+                                           gsl::index newTransactionIndex,
+                                           USD amount, const Date &date,
+                                           std::string_view description) {
+  writeMessagePack(batch, MessagePackMethod::updateTransactionRow,
+                   accountIndex, transactionIndex, newTransactionIndex,
+                   description, amount, date);
+}
+
+void MessagePackView::moveTransactionRow(gsl::index accountIndex,
+                                         gsl::index transactionIndex,
+                                         gsl::index newAccountIndex,
+                                         gsl::index newTransactionIndex) {
+  writeMessagePack(batch, MessagePackMethod::moveTransactionRow, accountIndex,
+                   transactionIndex, newAccountIndex, newTransactionIndex);
+}
+
+void MessagePackView::addTransactionRow(gsl::index accountIndex, USD amount,
+                                        const Date &date,
+                                        std::string_view description,
+                                        gsl::index transactionIndex,
+                                        TransactionId id) {
+  writeMessagePack(batch, MessagePackMethod::addTransactionRow, accountIndex,
+                   transactionIndex, description, amount, date,
+                   static_cast<std::int_least64_t>(id));
+}
+
+void MessagePackView::removeTransactionRowSelection(
+    gsl::index accountIndex, gsl::index transactionIndex) {
+  writeMessagePack(batch, MessagePackMethod::removeTransactionRowSelection,
+                   accountIndex, transactionIndex);
+}
+
+void MessagePackView::addNewAccountTable(std::string_view name,
+                                         gsl::index accountIndex) {
+  writeMessagePack(batch, MessageKind::accountIndexChange, 0,
+                   MessagePackMethod::addAccountTable, name, accountIndex);
+}
+
+void MessagePackView::deleteAccountTable(gsl::index accountIndex) {
+  writeMessagePack(batch, MessageKind::accountIndexChange, 0,
+                   MessagePackMethod::deleteAccountTable, accountIndex);
+}
+
+void MessagePackView::updateNetIncome(USD amount) {
+  writeMessagePack(batch, MessageKind::netIncome, 0,
+                   MessagePackMethod::updateNetIncome, amount);
+}
+
+void MessagePackView::markAsSaved() {
+  writeMessagePack(batch, MessageKind::savedState, 0,
+                   MessagePackMethod::markAsSaved);
+}
+
+void MessagePackView::markAsUnsaved() {
+  writeMessagePack(batch, MessageKind::savedState, 0,
+                   MessagePackMethod::markAsUnsaved);
+}
+
+void writeMessagePackFrame(std::string &frame, const MessageBatch &batch) {
+  const auto messages{batch.messages()};
+  appendMessagePackArrayHeader(frame, messages.size());
+  for (const auto message : messages)
+    frame += message;
+}
+
+void writeMessagePackFrame(std::string &frame, FrameHeader header,
+                           const MessageBatch &batch) {
+  appendMessagePackArrayHeader(frame, 3);
+  appendMessagePack(frame, static_cast<std::int_least64_t>(header.sequence));
+  frame += static_cast<char>(header.snapshot ? 0xC3U : 0xC2U);
+  writeMessagePackFrame(frame, batch);
+}
+
+static void skipWhitespace(std::string_view s, std::string_view::size_type &i) {
+  while (i < s.size() &&
+         (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r'))
+    ++i;
+}
+
+static auto consume(std::string_view s, std::string_view::size_type &i,
+                    char c) -> bool {
+  skipWhitespace(s, i);
+  if (i < s.size() && s[i] == c) {
+    ++i;
+    return true;
+  }
+  return false;
+}
+
+static auto hexQuad(std::string_view s, std::string_view::size_type &i,
+                    char32_t &codePoint) -> bool {
+  if (i + 4 > s.size())
+    return false;
+  codePoint = 0;
+  for (const auto end{i + 4}; i < end; ++i) {
+    const auto c{s[i]};
+    codePoint <<= 4U;
+    if (c >= '0' && c <= '9')
+      codePoint |= static_cast<char32_t>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      codePoint |= static_cast<char32_t>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      codePoint |= static_cast<char32_t>(c - 'A' + 10);
+    else
+      return false;
+  }
+  return true;
+}
+
+static void appendUtf8(std::string &out, char32_t c) {
+  if (c < 0x80U) {
+    out += static_cast<char>(c);
+  } else if (c < 0x800U) {
+    out += static_cast<char>(0xC0U | (c >> 6U));
+    out += static_cast<char>(0x80U | (c & 0x3FU));
+  } else if (c < 0x10000U) {
+    out += static_cast<char>(0xE0U | (c >> 12U));
+    out += static_cast<char>(0x80U | ((c >> 6U) & 0x3FU));
+    out += static_cast<char>(0x80U | (c & 0x3FU));
+  } else {
+    out += static_cast<char>(0xF0U | (c >> 18U));
+    out += static_cast<char>(0x80U | ((c >> 12U) & 0x3FU));
+    out += static_cast<char>(0x80U | ((c >> 6U) & 0x3FU));
+    out += static_cast<char>(0x80U | (c & 0x3FU));
+  }
+}
+
+static auto unescape(std::string_view s, std::string_view::size_type &i,
+                     std::string &out) -> bool {
+  if (i >= s.size())
+    return false;
+  switch (s[i++]) {
+  case '"':
+    out += '"';
+    return true;
+  case '\\':
+    out += '\\';
+    return true;
+  case '/':
+    out += '/';
+    return true;
+  case 'b':
+    out += '\b';
+    return true;
+  case 'f':
+    out += '\f';
+    return true;
+  case 'n':
+    out += '\n';
+    return true;
+  case 'r':
+    out += '\r';
+    return true;
+  case 't':
+    out += '\t';
+    return true;
+  case 'u': {
+    char32_t codePoint = 0;
+    if (!hexQuad(s, i, codePoint))
+      return false;
+    if (codePoint >= 0xD800U && codePoint < 0xDC00U) {
+      char32_t low = 0;
+      if (s.substr(i, 2) != "\\u" || !hexQuad(s, i += 2, low) ||
+          low < 0xDC00U || low >= 0xE000U)
+        return false;
+      codePoint = 0x10000U + ((codePoint - 0xD800U) << 10U) + (low - 0xDC00U);
+    } else if (codePoint >= 0xDC00U && codePoint < 0xE000U) {
+      return false;
+    }
+    appendUtf8(out, codePoint);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// Views the source directly unless the string has escapes, in which case it
+// is decoded into storage.
+static auto stringValue(std::string_view s, std::string_view::size_type &i,
+                        std::string &storage)
+    -> std::optional<std::string_view> {
+  if (!consume(s, i, '"'))
+    return std::nullopt;
+  const auto begin{i};
+  while (i < s.size() && s[i] != '"' && s[i] != '\\')
+    ++i;
+  if (i >= s.size())
+    return std::nullopt;
+  if (s[i] == '"')
+    return s.substr(begin, i++ - begin);
+  storage.assign(s.substr(begin, i - begin));
+  while (i < s.size() && s[i] != '"') {
+    if (s[i] == '\\') {
+      if (!unescape(s, ++i, storage))
+        return std::nullopt;
+    } else {
+      storage += s[i++];
+    }
+  }
+  if (i >= s.size())
+    return std::nullopt;
+  ++i;
+  return storage;
+}
+
+static auto skipValue(std::string_view s, std::string_view::size_type &i)
+    -> bool {
+  skipWhitespace(s, i);
+  if (i >= s.size())
+    return false;
+  if (s[i] == '"') {
+    std::string ignored;
+    return stringValue(s, i, ignored).has_value();
+  }
+  if (s[i] == '{' || s[i] == '[') {
+    const auto close{s[i] == '{' ? '}' : ']'};
+    ++i;
+    if (consume(s, i, close))
+      return true;
+    do {
+      if (close == '}' && (!skipValue(s, i) || !consume(s, i, ':')))
+        return false;
+      if (!skipValue(s, i))
+        return false;
+    } while (consume(s, i, ','));
+    return consume(s, i, close);
+  }
+  const auto begin{i};
+  while (i < s.size() && s[i] != ',' && s[i] != '}' && s[i] != ']' &&
+         s[i] != ' ' && s[i] != '\t' && s[i] != '\n' && s[i] != '\r')
+    ++i;
+  return i != begin;
+}
+
+static auto method(std::string_view s) -> Command::Method {
+  const auto is{[s](std::string_view name, Command::Method method) {
+    return s == name ? method : Command::Method::unknown;
+  }};
+  switch (s.size()) {
+  case 4:
+    return is("save", Command::Method::save);
+  case 6:
+    return is("reduce", Command::Method::reduce);
+  case 7:
+    return is("restore", Command::Method::restore);
+  case 8:
+    return s[0] == 't' ? is("transfer", Command::Method::transfer)
+                       : is("allocate", Command::Method::allocate);
+  case 13:
+    return is("close account", Command::Method::closeAccount);
+  case 14:
+    switch (s[2]) {
+    case 'n':
+      return is("rename account", Command::Method::renameAccount);
+    case 'e':
+      return is("create account", Command::Method::createAccount);
+    default:
+      return is("remove account", Command::Method::removeAccount);
+    }
+  case 15:
+    return is("add transaction", Command::Method::addTransaction);
+  case 16:
+    return is("move transaction", Command::Method::moveTransaction);
+  case 18:
+    switch (s[0]) {
+    case 'r':
+      return is("remove transaction", Command::Method::removeTransaction);
+    case 'v':
+      return is("verify transaction", Command::Method::verifyTransaction);
+    default:
+      return is("update transaction", Command::Method::updateTransaction);
+    }
+  default:
+    return Command::Method::unknown;
+  }
+}
+
+auto methodName(Command::Method method) -> std::string_view {
+  switch (method) {
+  case Command::Method::unknown:
+    return "unknown";
+  case Command::Method::save:
+    return "save";
+  case Command::Method::reduce:
+    return "reduce";
+  case Command::Method::restore:
+    return "restore";
+  case Command::Method::transfer:
+    return "transfer";
+  case Command::Method::allocate:
+    return "allocate";
+  case Command::Method::addTransaction:
+    return "add transaction";
+  case Command::Method::removeTransaction:
+    return "remove transaction";
+  case Command::Method::verifyTransaction:
+    return "verify transaction";
+  case Command::Method::updateTransaction:
+    return "update transaction";
+  case Command::Method::moveTransaction:
+    return "move transaction";
+  case Command::Method::createAccount:
+    return "create account";
+  case Command::Method::renameAccount:
+    return "rename account";
+  case Command::Method::removeAccount:
+    return "remove account";
+  case Command::Method::closeAccount:
+    return "close account";
+  }
+  return "unknown";
+}
+
+static auto integer(std::string_view s, std::string_view::size_type &i)
+    -> int {
+  auto value{0};
+  const auto [end, error]{
+      std::from_chars(s.data() + i, s.data() + s.size(), value)};
+  i = end - s.data();
+  if (i < s.size())
+    ++i;
+  return value;
+}
+
+// Accepts both 2021-11-20 from a date input and 11/20/2021 from a table row.
+static auto date(std::string_view s) -> Date {
+  std::string_view::size_type i{0};
+  if (s.find('-') != std::string_view::npos) {
+    const auto year{integer(s, i)};
+    const auto month{integer(s, i)};
+    return Date{year, Month{month}, integer(s, i)};
+  }
+  const auto month{integer(s, i)};
+  const auto day{integer(s, i)};
+  return Date{integer(s, i), Month{month}, day};
+}
+
+static auto transactionId(std::string_view s, std::string_view::size_type &i)
+    -> std::optional<TransactionId> {
+  TransactionId id{0};
+  const auto [end, error]{
+      std::from_chars(s.data() + i, s.data() + s.size(), id)};
+  if (error != std::errc{})
+    return std::nullopt;
+  i = end - s.data();
+  return id;
+}
+
+static void assign(Command &command, std::string_view key,
+                   std::string_view value) {
+  if (key == "method")
+    command.method = method(value);
+  else if (key == "name")
+    command.accountName = value;
+  else if (key == "newName")
+    command.newAccountName = value;
+  else if (key == "amount")
+    command.transaction.amount = usd(value);
+  else if (key == "description")
+    command.transaction.description = value;
+  else if (key == "date")
+    command.transaction.date = date(value);
+}
+
+auto jsonCommand(std::string_view s) -> Command {
+  Command command;
+  std::string::size_type i{0};
+  std::string keyStorage;
+  std::string valueStorage;
+  if (!consume(s, i, '{'))
+    return {};
+  if (consume(s, i, '}'))
+    return command;
+  do {
+    const auto key{stringValue(s, i, keyStorage)};
+    if (!key || !consume(s, i, ':'))
+      return {};
+    skipWhitespace(s, i);
+    if (i < s.size() && s[i] == '"') {
+      const auto value{stringValue(s, i, valueStorage)};
+      if (!value)
+        return {};
+      assign(command, *key, *value);
+    } else if (*key == "id") {
+      command.transactionId = transactionId(s, i);
+      if (!command.transactionId)
+        return {};
+    } else if (!skipValue(s, i)) {
+      return {};
+    }
+  } while (consume(s, i, ','));
+  if (!consume(s, i, '}'))
+    return {};
+  return command;
+}
+
+static auto isIncome(const Command &command) -> bool {
+  return command.accountName == incomeAccountName;
+}
+
+void apply(Budget &budget, const Command &command) {
+  switch (command.method) {
+  case Command::Method::addTransaction:
+    if (isIncome(command))
+      budget.addIncome(command.transaction);
+    else
+      budget.addExpense(command.accountName, command.transaction);
+    break;
+  case Command::Method::removeTransaction:
+    if (command.transactionId && isIncome(command))
+      budget.removeIncome(*command.transactionId);
+    else if (command.transactionId)
+      budget.removeExpense(command.accountName, *command.transactionId);
+    else if (isIncome(command))
+      budget.removeIncome(command.transaction);
+    else
+      budget.removeExpense(command.accountName, command.transaction);
+    break;
+  case Command::Method::verifyTransaction:
+    if (command.transactionId && isIncome(command))
+      budget.verifyIncome(*command.transactionId);
+    else if (command.transactionId)
+      budget.verifyExpense(command.accountName, *command.transactionId);
+    else if (isIncome(command))
+      budget.verifyIncome(command.transaction);
+    else
+      budget.verifyExpense(command.accountName, command.transaction);
+    break;
+  case Command::Method::updateTransaction:
+    if (command.transactionId && isIncome(command))
+      budget.updateIncome(*command.transactionId, command.transaction);
+    else if (command.transactionId)
+      budget.updateExpense(command.accountName, *command.transactionId,
+                           command.transaction);
+    break;
+  case Command::Method::moveTransaction:
+    if (command.transactionId)
+      budget.moveExpense(command.accountName, command.newAccountName,
+                         *command.transactionId);
+    break;
+  case Command::Method::transfer:
+    budget.transferTo(command.accountName, command.transaction.amount);
+    break;
+  case Command::Method::allocate:
+    budget.allocate(command.accountName, command.transaction.amount);
+    break;
+  case Command::Method::reduce:
+    budget.reduce();
+    break;
+  case Command::Method::restore:
+    budget.restore();
+    break;
+  case Command::Method::renameAccount:
+    budget.renameAccount(command.accountName, command.newAccountName);
+    break;
+  case Command::Method::createAccount:
+    budget.createAccount(command.newAccountName);
+    break;
+  case Command::Method::removeAccount:
+    budget.removeAccount(command.accountName);
+    break;
+  case Command::Method::closeAccount:
+    budget.closeAccount(command.accountName);
+    break;
+  case Command::Method::save:
+  case Command::Method::unknown:
+    break;
+  }
+}
+} // namespace sbash64::budget
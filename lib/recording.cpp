@@ -0,0 +1,99 @@
+#include "recording.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace sbash64::budget {
+static constexpr std::string_view magic{"sbash64-budget-recording 1\n"};
+
+static void writeVarint(std::ostream &stream, std::uint_least64_t value) {
+  std::array<char, 10> bytes{};
+  std::size_t size{0};
+  do {
+    bytes.at(size) = static_cast<char>(value & 0x7f);
+    value >>= 7;
+    if (value != 0)
+      bytes.at(size) = static_cast<char>(bytes.at(size) | 0x80);
+    ++size;
+  } while (value != 0);
+  stream.write(bytes.data(), static_cast<std::streamsize>(size));
+}
+
+static auto readVarint(std::istream &stream)
+    -> std::optional<std::uint_least64_t> {
+  std::uint_least64_t value{0};
+  for (auto shift{0}; shift < std::numeric_limits<std::uint_least64_t>::digits;
+       shift += 7) {
+    const auto c{stream.get()};
+    if (c == std::istream::traits_type::eof())
+      return std::nullopt;
+    value |= static_cast<std::uint_least64_t>(c & 0x7f) << shift;
+    if ((c & 0x80) == 0)
+      return value;
+  }
+  return std::nullopt;
+}
+
+static void writeString(std::ostream &stream, std::string_view s) {
+  writeVarint(stream, s.size());
+  stream.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+static auto readString(std::istream &stream) -> std::optional<std::string> {
+  const auto size{readVarint(stream)};
+  if (!size)
+    return std::nullopt;
+  std::string s(*size, '\0');
+  if (!stream.read(s.data(), static_cast<std::streamsize>(s.size())))
+    return std::nullopt;
+  return s;
+}
+
+RecordingWriter::RecordingWriter(std::ostream &stream, std::string_view budget)
+    : stream{stream} {
+  stream << magic;
+  writeString(stream, budget);
+}
+
+void RecordingWriter::write(std::chrono::microseconds sinceStart,
+                            std::string_view payload) {
+  const auto time{std::max(sinceStart, last)};
+  writeVarint(stream, static_cast<std::uint_least64_t>((time - last).count()));
+  writeString(stream, payload);
+  last = time;
+}
+
+RecordingReader::RecordingReader(std::istream &stream) : stream{stream} {
+  std::string start(magic.size(), '\0');
+  if (!stream.read(start.data(), static_cast<std::streamsize>(start.size())) ||
+      start != magic)
+    return;
+  auto budget{readString(stream)};
+  if (!budget)
+    return;
+  budget_ = std::move(*budget);
+  valid_ = true;
+}
+
+auto RecordingReader::valid() const -> bool { return valid_; }
+
+auto RecordingReader::budget() const -> const std::string & {
+  return budget_;
+}
+
+auto RecordingReader::next() -> std::optional<RecordedPayload> {
+  if (!valid_)
+    return std::nullopt;
+  const auto elapsed{readVarint(stream)};
+  if (!elapsed)
+    return std::nullopt;
+  auto payload{readString(stream)};
+  if (!payload)
+    return std::nullopt;
+  last += std::chrono::microseconds{*elapsed};
+  return RecordedPayload{last, std::move(*payload)};
+}
+} // namespace sbash64::budget
@@ -0,0 +1,185 @@
+#include "trace.hpp"
+#include "protocol.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <utility>
+
+namespace sbash64::budget {
+namespace {
+// The spans open on this thread and the finished descendants of the
+// outermost one.
+struct ThreadSpans {
+  int depth{};
+  std::vector<TraceEvent> tree;
+};
+} // namespace
+
+static thread_local ThreadSpans threadSpans;
+
+static auto threadId() -> std::uint_least32_t {
+  static std::atomic<std::uint_least32_t> threads{0};
+  static thread_local const auto id{++threads};
+  return id;
+}
+
+static void append(std::string &out, double value) {
+  std::array<char, 32> digits{};
+  const auto [end, error]{std::to_chars(digits.data(),
+                                        digits.data() + digits.size(), value,
+                                        std::chars_format::fixed, 3)};
+  out.append(digits.data(), end);
+}
+
+static auto milliseconds(std::chrono::nanoseconds duration) -> double {
+  return std::chrono::duration<double, std::milli>{duration}.count();
+}
+
+static auto microseconds(std::chrono::nanoseconds duration) -> double {
+  return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+static auto end(const TraceEvent &event) -> std::chrono::nanoseconds {
+  return event.begin + event.duration;
+}
+
+static auto formatTree(std::vector<TraceEvent> tree) -> std::string {
+  std::stable_sort(tree.begin(), tree.end(),
+                   [](const TraceEvent &a, const TraceEvent &b) {
+                     return a.begin < b.begin ||
+                            (a.begin == b.begin && a.depth < b.depth);
+                   });
+  std::string out{"slow:\n"};
+  for (const auto &event : tree) {
+    out.append(2 * static_cast<std::size_t>(event.depth + 1), ' ');
+    out += event.name;
+    if (!event.detail.empty()) {
+      out += ' ';
+      out += event.detail;
+    }
+    out += ' ';
+    append(out, milliseconds(event.duration));
+    out += " ms\n";
+  }
+  return out;
+}
+
+// Only its thread writes to a ring, so its lock is contended only while the
+// events are read.
+struct Tracer::Ring {
+  explicit Ring(std::size_t capacity) : events(capacity) {}
+
+  std::vector<TraceEvent> events;
+  std::size_t next{};
+  std::size_t size{};
+  std::mutex mutex;
+};
+
+Tracer::Tracer(std::size_t capacity, std::chrono::nanoseconds slowThreshold,
+               std::ostream &log)
+    : capacity{std::max<std::size_t>(capacity, 1)},
+      id{[] {
+        static std::atomic<std::uint_least64_t> tracers{0};
+        return ++tracers;
+      }()},
+      start{std::chrono::steady_clock::now()}, slowThreshold{slowThreshold},
+      log{log} {}
+
+Tracer::~Tracer() = default;
+
+auto Tracer::ring() -> Ring & {
+  static thread_local std::vector<std::pair<std::uint_least64_t, Ring *>>
+      threadRings;
+  for (const auto &[tracer, ring] : threadRings)
+    if (tracer == id)
+      return *ring;
+  std::lock_guard lock{ringsMutex};
+  auto &ring{*rings.emplace_back(std::make_unique<Ring>(capacity))};
+  threadRings.emplace_back(id, &ring);
+  return ring;
+}
+
+auto Tracer::events() const -> std::vector<TraceEvent> {
+  std::vector<TraceEvent> oldestFirst;
+  {
+    std::lock_guard lock{ringsMutex};
+    for (const auto &ring : rings) {
+      std::lock_guard ringLock{ring->mutex};
+      const auto &events{ring->events};
+      for (auto i{events.size() + ring->next - ring->size};
+           i < events.size() + ring->next; ++i)
+        oldestFirst.push_back(events.at(i % events.size()));
+    }
+  }
+  std::stable_sort(oldestFirst.begin(), oldestFirst.end(),
+                   [](const TraceEvent &a, const TraceEvent &b) {
+                     return end(a) < end(b);
+                   });
+  return oldestFirst;
+}
+
+auto Tracer::now() const -> std::chrono::nanoseconds {
+  return std::chrono::steady_clock::now() - start;
+}
+
+void Tracer::add(TraceEvent event) {
+  auto &spans{threadSpans};
+  const auto outermost{event.depth == 0};
+  const auto slow{outermost && event.duration >= slowThreshold};
+  if (spans.tree.size() < capacity)
+    spans.tree.push_back(event);
+  {
+    auto &ring{this->ring()};
+    std::lock_guard lock{ring.mutex};
+    ring.events.at(ring.next) = std::move(event);
+    ring.next = (ring.next + 1) % ring.events.size();
+    ring.size = std::min(ring.size + 1, ring.events.size());
+  }
+  if (slow) {
+    const auto out{formatTree(spans.tree)};
+    std::lock_guard lock{logMutex};
+    log << out << std::flush;
+  }
+  if (outermost)
+    spans.tree.clear();
+}
+
+TraceSpan::TraceSpan(Tracer &tracer, std::string_view name,
+                     std::string detail)
+    : tracer{tracer}, name{name}, detail{std::move(detail)},
+      begin{tracer.now()}, depth{threadSpans.depth++} {}
+
+TraceSpan::~TraceSpan() {
+  --threadSpans.depth;
+  tracer.add({name, std::move(detail), threadId(), depth, begin,
+              tracer.now() - begin});
+}
+
+void writeChromeTrace(std::string &out,
+                      const std::vector<TraceEvent> &events) {
+  out += R"({"traceEvents":[)";
+  auto first{true};
+  for (const auto &event : events) {
+    if (!first)
+      out += ',';
+    first = false;
+    out += R"({"name":)";
+    writeJsonString(out, event.name);
+    out += R"(,"ph":"X","pid":1,"tid":)";
+    out += std::to_string(event.thread);
+    out += R"(,"ts":)";
+    append(out, microseconds(event.begin));
+    out += R"(,"dur":)";
+    append(out, microseconds(event.duration));
+    if (!event.detail.empty()) {
+      out += R"(,"args":{"detail":)";
+      writeJsonString(out, event.detail);
+      out += '}';
+    }
+    out += '}';
+  }
+  out += R"(],"displayTimeUnit":"ms"})";
+}
+} // namespace sbash64::budget
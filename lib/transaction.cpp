@@ -1,27 +1,51 @@
 #include "transaction.hpp"
+#include "memory.hpp"
 
 #include <functional>
 
 namespace sbash64::budget {
+ObservableTransactionInMemory::ObservableTransactionInMemory(TransactionId id)
+    : id_{id} {}
+
 void ObservableTransactionInMemory::attach(Observer &a) {
   observers.push_back(std::ref(a));
 }
 
-void ObservableTransactionInMemory::initialize(const Transaction &transaction) {
+static void assign(
+    ArchivableVerifiableTransaction &archivableVerifiableTransaction,
+    const std::vector<std::reference_wrapper<ObservableTransaction::Observer>>
+        &observers,
+    const Transaction &transaction) {
   static_cast<Transaction &>(archivableVerifiableTransaction) = transaction;
   for (auto observer : observers)
     observer.get().notifyThatIs(transaction);
 }
 
+void ObservableTransactionInMemory::initialize(const Transaction &transaction) {
+  assign(archivableVerifiableTransaction, observers, transaction);
+}
+
+void ObservableTransactionInMemory::update(const Transaction &transaction) {
+  if (static_cast<Transaction &>(archivableVerifiableTransaction) !=
+      transaction)
+    assign(archivableVerifiableTransaction, observers, transaction);
+}
+
 auto ObservableTransactionInMemory::verifies(const Transaction &match) -> bool {
   if (!archivableVerifiableTransaction.verified &&
       static_cast<Transaction &>(archivableVerifiableTransaction) == match) {
+    verify();
+    return true;
+  }
+  return false;
+}
+
+void ObservableTransactionInMemory::verify() {
+  if (!archivableVerifiableTransaction.verified) {
     archivableVerifiableTransaction.verified = true;
     for (auto observer : observers)
       observer.get().notifyThatIsVerified();
-    return true;
   }
-  return false;
 }
 
 static void remove(
@@ -62,8 +86,15 @@ auto ObservableTransactionInMemory::amount() -> USD {
   return archivableVerifiableTransaction.amount;
 }
 
+auto ObservableTransactionInMemory::id() -> TransactionId { return id_; }
+
+auto ObservableTransactionInMemory::memory() -> TransactionMemory {
+  return {sizeof *this, heapBytes(archivableVerifiableTransaction.description),
+          heapBytes(observers)};
+}
+
 auto ObservableTransactionInMemory::Factory::make()
     -> std::shared_ptr<ObservableTransaction> {
-  return std::make_shared<ObservableTransactionInMemory>();
+  return std::make_shared<ObservableTransactionInMemory>(nextId++);
 }
 } // namespace sbash64::budget
@@ -0,0 +1,120 @@
+#include <sbash64/budget/allocations.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace sbash64::budget {
+// Per thread so that other threads' allocations don't count, and trivial so
+// that operator new can use them before anything is constructed.
+static thread_local std::uint_least64_t allocationCount;
+static thread_local std::uint_least64_t byteCount;
+
+AllocationsSince::AllocationsSince()
+    : allocations_{allocationCount}, bytes_{byteCount} {}
+
+auto AllocationsSince::allocations() const -> std::uint_least64_t {
+  return allocationCount - allocations_;
+}
+
+auto AllocationsSince::bytes() const -> std::uint_least64_t {
+  return byteCount - bytes_;
+}
+
+static auto allocate(std::size_t size) -> void * {
+  ++allocationCount;
+  byteCount += size;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+static auto allocate(std::size_t size, std::align_val_t alignment) -> void * {
+  ++allocationCount;
+  byteCount += size;
+  const auto align{static_cast<std::size_t>(alignment)};
+#ifdef _WIN32
+  // MSVC has no aligned_alloc, and what _aligned_malloc returns goes back
+  // through _aligned_free.
+  return _aligned_malloc(size == 0 ? align : size, align);
+#else
+  // aligned_alloc takes a multiple of the alignment, and may fail on zero.
+  return std::aligned_alloc(
+      align, size == 0 ? align : (size + align - 1) / align * align);
+#endif
+}
+
+static void releaseAligned(void *p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+static auto orThrow(void *p) -> void * {
+  if (p == nullptr)
+    throw std::bad_alloc{};
+  return p;
+}
+} // namespace sbash64::budget
+
+auto operator new(std::size_t size) -> void * {
+  return sbash64::budget::orThrow(sbash64::budget::allocate(size));
+}
+
+auto operator new[](std::size_t size) -> void * {
+  return sbash64::budget::orThrow(sbash64::budget::allocate(size));
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void * {
+  return sbash64::budget::orThrow(sbash64::budget::allocate(size, alignment));
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void * {
+  return sbash64::budget::orThrow(sbash64::budget::allocate(size, alignment));
+}
+
+auto operator new(std::size_t size, const std::nothrow_t &) noexcept
+    -> void * {
+  return sbash64::budget::allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t &) noexcept
+    -> void * {
+  return sbash64::budget::allocate(size);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete[](void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept {
+  sbash64::budget::releaseAligned(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept {
+  sbash64::budget::releaseAligned(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  sbash64::budget::releaseAligned(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  sbash64::budget::releaseAligned(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
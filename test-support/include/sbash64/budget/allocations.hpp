@@ -0,0 +1,22 @@
+#ifndef SBASH64_BUDGET_ALLOCATIONS_HPP_
+#define SBASH64_BUDGET_ALLOCATIONS_HPP_
+
+#include <cstdint>
+
+namespace sbash64::budget {
+// Counts the allocations made through operator new on this thread since it
+// was constructed. Only programs that link sbash64-budget-allocations, which
+// replaces the global operator new and delete, count anything.
+class AllocationsSince {
+public:
+  AllocationsSince();
+  [[nodiscard]] auto allocations() const -> std::uint_least64_t;
+  [[nodiscard]] auto bytes() const -> std::uint_least64_t;
+
+private:
+  std::uint_least64_t allocations_;
+  std::uint_least64_t bytes_;
+};
+} // namespace sbash64::budget
+
+#endif
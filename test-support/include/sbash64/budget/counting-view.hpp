@@ -0,0 +1,48 @@
+#ifndef SBASH64_BUDGET_COUNTING_VIEW_HPP_
+#define SBASH64_BUDGET_COUNTING_VIEW_HPP_
+
+#include <sbash64/budget/presentation.hpp>
+
+#include <gsl/gsl>
+
+#include <cstdint>
+#include <string_view>
+
+namespace sbash64::budget {
+// A view that only counts what it is told.
+class CountingView : public View {
+public:
+  void updateNetIncome(USD) override { ++calls; }
+  void addNewAccountTable(std::string_view, gsl::index) override { ++calls; }
+  void deleteAccountTable(gsl::index) override { ++calls; }
+  void setAccountName(gsl::index, std::string_view) override { ++calls; }
+  void updateAccountAllocation(gsl::index, USD) override { ++calls; }
+  void updateAccountBalance(gsl::index, USD) override { ++calls; }
+  void addTransactionRow(gsl::index, USD, const Date &, std::string_view,
+                         gsl::index, TransactionId) override {
+    ++calls;
+  }
+  void deleteTransactionRow(gsl::index, gsl::index) override { ++calls; }
+  void updateTransactionRow(gsl::index, gsl::index, gsl::index, USD,
+                            const Date &, std::string_view) override {
+    ++calls;
+  }
+  void moveTransactionRow(gsl::index, gsl::index, gsl::index,
+                          gsl::index) override {
+    ++calls;
+  }
+  void putCheckmarkNextToTransactionRow(gsl::index, gsl::index) override {
+    ++calls;
+  }
+  void removeTransactionRowSelection(gsl::index, gsl::index) override {
+    ++calls;
+  }
+  void markAsSaved() override { ++calls; }
+  void markAsUnsaved() override { ++calls; }
+  void reorderAccountIndex(gsl::index, gsl::index) override { ++calls; }
+
+  std::uint_least64_t calls{};
+};
+} // namespace sbash64::budget
+
+#endif
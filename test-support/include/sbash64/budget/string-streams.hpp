@@ -0,0 +1,33 @@
+#ifndef SBASH64_BUDGET_STRING_STREAMS_HPP_
+#define SBASH64_BUDGET_STRING_STREAMS_HPP_
+
+#include <sbash64/budget/serialization.hpp>
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace sbash64::budget {
+// Keeps the budget file in a string: what is written replaces it once the
+// output stream is released, and input reads it back.
+class StringStreamFactory : public IoStreamFactory {
+public:
+  auto makeInput() -> std::shared_ptr<std::istream> override {
+    return std::make_shared<std::istringstream>(file);
+  }
+
+  auto makeOutput() -> std::shared_ptr<std::ostream> override {
+    auto stream{std::make_shared<std::ostringstream>()};
+    return {stream.get(), [this, stream](std::ostream *) {
+              file = std::move(*stream).str();
+            }};
+  }
+
+  std::string file;
+};
+} // namespace sbash64::budget
+
+#endif
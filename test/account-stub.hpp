@@ -3,6 +3,9 @@
 
 #include <sbash64/budget/domain.hpp>
 
+#include <memory>
+#include <utility>
+
 namespace sbash64::budget {
 class AccountStub : public virtual Account {
 public:
@@ -11,6 +14,8 @@ public:
     renamed = true;
   }
 
+  auto memory() -> AccountMemory override { return {}; }
+
   auto decreasedAllocationAmount() -> USD { return decreasedAllocationAmount_; }
 
   auto increasedAllocationAmount() -> USD { return increasedAllocationAmount_; }
@@ -83,6 +88,11 @@ public:
     removedTransaction_ = t;
   }
 
+  void remove(TransactionId id) override {
+    transactionRemoved_ = true;
+    removedTransactionId = id;
+  }
+
   [[nodiscard]] auto transactionRemoved() const -> bool {
     return transactionRemoved_;
   }
@@ -91,6 +101,23 @@ public:
 
   void verify(const Transaction &t) override { verifiedTransaction_ = t; }
 
+  void verify(TransactionId id) override { verifiedTransactionId = id; }
+
+  auto release(TransactionId id)
+      -> std::shared_ptr<ObservableTransaction> override {
+    releasedTransactionId = id;
+    return releasedTransaction;
+  }
+
+  void adopt(std::shared_ptr<ObservableTransaction> t) override {
+    adoptedTransaction = std::move(t);
+  }
+
+  void update(TransactionId id, const Transaction &t) override {
+    updatedTransactionId = id;
+    updatedTransaction = t;
+  }
+
   auto addedTransaction() -> Transaction { return addedTransaction_; }
 
   auto removedTransaction() -> Transaction { return removedTransaction_; }
@@ -98,6 +125,13 @@ public:
   auto observer() -> Observer * { return observer_; }
 
   std::string newName;
+  TransactionId removedTransactionId{};
+  TransactionId verifiedTransactionId{};
+  TransactionId updatedTransactionId{};
+  Transaction updatedTransaction;
+  TransactionId releasedTransactionId{};
+  std::shared_ptr<ObservableTransaction> releasedTransaction;
+  std::shared_ptr<ObservableTransaction> adoptedTransaction;
   bool renamed{};
 
 private:
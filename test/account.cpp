@@ -9,10 +9,17 @@
 
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 namespace sbash64::budget::account {
 namespace {
+// Distinct, as an account requires, and clear of the IDs tests set.
+auto distinctId() -> TransactionId {
+  static TransactionId next{1000};
+  return next++;
+}
+
 class ObservableTransactionStub : public ObservableTransaction {
 public:
   void attach(Observer &) override {}
@@ -50,7 +57,24 @@ public:
 
   void setAmount(USD x) { amount_ = x; }
 
-  void remove() override {}
+  void remove() override { removed_ = true; }
+
+  [[nodiscard]] auto removed() const -> bool { return removed_; }
+
+  void verify() override { verified_ = true; }
+
+  void update(const Transaction &t) override {
+    updatedTransaction_ = t;
+    amount_ = t.amount;
+  }
+
+  auto updatedTransaction() -> Transaction { return updatedTransaction_; }
+
+  void setId(TransactionId id) { id_ = id; }
+
+  auto id() -> TransactionId override { return id_; }
+
+  auto memory() -> TransactionMemory override { return {}; }
 
   void archive() override { wasArchived_ = true; }
 
@@ -67,8 +91,11 @@ public:
 
 private:
   Transaction initializedTransaction_;
+  Transaction updatedTransaction_;
   const Transaction *removesTransaction_{};
   USD amount_;
+  TransactionId id_{distinctId()};
+  bool removed_{};
   bool removes_{};
   bool removesed_{};
   bool verified_{};
@@ -194,7 +221,8 @@ addObservableTransactionStub(ObservableTransactionFactoryStub &factory)
 static auto
 addObservableTransactionInMemory(ObservableTransactionFactoryStub &factory)
     -> std::shared_ptr<ObservableTransactionInMemory> {
-  auto transaction{std::make_shared<ObservableTransactionInMemory>()};
+  auto transaction{
+      std::make_shared<ObservableTransactionInMemory>(distinctId())};
   factory.add(transaction);
   return transaction;
 }
@@ -292,6 +320,147 @@ void attemptsToRemoveEachCreditUntilFound(testcpplite::TestResult &result) {
   });
 }
 
+void removesTransactionById(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &factory) {
+    AccountObserverStub observer;
+    account.attach(observer);
+    const auto mike{addObservableTransactionStub(factory)};
+    mike->setId(1);
+    mike->setAmount(3_cents);
+    add(account);
+    const auto andy{addObservableTransactionStub(factory)};
+    andy->setId(2);
+    andy->setAmount(11_cents);
+    add(account);
+    account.remove(TransactionId{2});
+    assertFalse(result, mike->removed());
+    assertTrue(result, andy->removed());
+    assertBalanceEquals(result, 3_cents, observer);
+    PersistentAccountStub persistence;
+    account.save(persistence);
+    assertSaved(result, persistence, {mike.get()});
+  });
+}
+
+void verifiesTransactionById(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &factory) {
+    TransactionDeserializationStub deserialization;
+    const auto mike{addObservableTransactionStub(factory)};
+    mike->setId(1);
+    account.notifyThatIsReady(deserialization);
+    const auto andy{addObservableTransactionStub(factory)};
+    andy->setId(2);
+    account.notifyThatIsReady(deserialization);
+    account.verify(TransactionId{2});
+    assertFalse(result, mike->verified());
+    assertTrue(result, andy->verified());
+  });
+}
+
+void updatesTransactionById(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &factory) {
+    AccountObserverStub observer;
+    account.attach(observer);
+    const auto mike{addObservableTransactionStub(factory)};
+    mike->setId(1);
+    add(account);
+    const auto andy{addObservableTransactionStub(factory)};
+    andy->setId(2);
+    andy->setAmount(11_cents);
+    add(account);
+    account.update(TransactionId{1},
+                   {5_cents, "hyvee", Date{2020, Month::June, 1}});
+    assertEqual(result, {5_cents, "hyvee", Date{2020, Month::June, 1}},
+                mike->updatedTransaction());
+    assertEqual(result, Transaction{}, andy->updatedTransaction());
+    assertBalanceEquals(result, 5_cents + 11_cents, observer);
+  });
+}
+
+void releasesTransactionById(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &factory) {
+    AccountObserverStub observer;
+    account.attach(observer);
+    const auto mike{addObservableTransactionStub(factory)};
+    mike->setId(1);
+    mike->setAmount(3_cents);
+    add(account);
+    const auto andy{addObservableTransactionStub(factory)};
+    andy->setId(2);
+    andy->setAmount(11_cents);
+    add(account);
+    assertTrue(result, account.release(TransactionId{2}) == andy);
+    assertFalse(result, andy->removed());
+    assertBalanceEquals(result, 3_cents, observer);
+    assertTrue(result, account.release(TransactionId{2}) == nullptr);
+    PersistentAccountStub persistence;
+    account.save(persistence);
+    assertSaved(result, persistence, {mike.get()});
+  });
+}
+
+void adoptsTransaction(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &) {
+    AccountObserverStub observer;
+    account.attach(observer);
+    const auto mike{std::make_shared<ObservableTransactionStub>()};
+    mike->setId(1);
+    mike->setAmount(3_cents);
+    account.adopt(mike);
+    assertBalanceEquals(result, 3_cents, observer);
+    account.verify(TransactionId{1});
+    assertTrue(result, mike->verified());
+    PersistentAccountStub persistence;
+    account.save(persistence);
+    assertSaved(result, persistence, {mike.get()});
+  });
+}
+
+void rejectsTransactionWithIdInUse(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &) {
+    AccountObserverStub observer;
+    account.attach(observer);
+    const auto mike{std::make_shared<ObservableTransactionStub>()};
+    mike->setId(1);
+    mike->setAmount(3_cents);
+    account.adopt(mike);
+    const auto andy{std::make_shared<ObservableTransactionStub>()};
+    andy->setId(1);
+    andy->setAmount(11_cents);
+    auto rejected{false};
+    try {
+      account.adopt(andy);
+    } catch (const std::runtime_error &) {
+      rejected = true;
+    }
+    assertTrue(result, rejected);
+    assertTrue(result, andy->removed());
+    assertBalanceEquals(result, 3_cents, observer);
+    PersistentAccountStub persistence;
+    account.save(persistence);
+    assertSaved(result, persistence, {mike.get()});
+  });
+}
+
+void doesNotRemoveArchivedTransactionById(testcpplite::TestResult &result) {
+  testInMemoryAccount([&result](AccountInMemory &account,
+                                ObservableTransactionFactoryStub &factory) {
+    const auto mike{addObservableTransactionStub(factory)};
+    mike->setId(1);
+    add(account);
+    mike->setVerified();
+    account.increaseAllocationByResolvingVerifiedTransactions();
+    account.remove(TransactionId{1});
+    assertFalse(result, mike->removed());
+  });
+}
+
 void savesLoadedTransactions(testcpplite::TestResult &result) {
   testInMemoryAccount([&result](AccountInMemory &account,
                                 ObservableTransactionFactoryStub &factory) {
@@ -315,7 +484,7 @@ void savesRemainingTransactionsAfterRemovingSome(
     const auto orangutan{addObservableTransactionStub(factory)};
     add(account);
     orangutan->setRemoves();
-    account.remove({});
+    account.remove(Transaction{});
     PersistentAccountStub persistence;
     account.save(persistence);
     assertSaved(result, persistence, {ape.get()});
@@ -331,14 +500,14 @@ void notifiesObserverOfUpdatedBalanceAfterRemovingTransactions(
     const auto ape{addObservableTransactionStub(factory)};
     const auto orangutan{addObservableTransactionStub(factory)};
     const auto chimp{addObservableTransactionStub(factory)};
-    add(account);
-    add(account);
-    add(account);
     ape->setAmount(1_cents);
     orangutan->setAmount(2_cents);
     chimp->setAmount(3_cents);
+    add(account);
+    add(account);
+    add(account);
     orangutan->setRemoves();
-    account.remove({});
+    account.remove(Transaction{});
     assertBalanceEquals(result, 1_cents + 3_cents, observer);
   });
 }
@@ -432,12 +601,12 @@ void notifiesUpdatedBalanceAfterArchivingVerified(
     const auto orangutan{addObservableTransactionStub(factory)};
     const auto gorilla{addObservableTransactionStub(factory)};
     const auto chimp{addObservableTransactionStub(factory)};
-    add(account);
-    add(account);
-    add(account);
     orangutan->setAmount(1_cents);
     gorilla->setAmount(2_cents);
     chimp->setAmount(3_cents);
+    add(account);
+    add(account);
+    add(account);
     gorilla->setVerified();
     account.increaseAllocationByResolvingVerifiedTransactions();
     assertEqual(result, 1_cents + 3_cents, account.balance());
@@ -467,10 +636,10 @@ void returnsBalance(testcpplite::TestResult &result) {
                                 ObservableTransactionFactoryStub &factory) {
     const auto orangutan{addObservableTransactionStub(factory)};
     const auto gorilla{addObservableTransactionStub(factory)};
-    add(account);
-    add(account);
     orangutan->setAmount(1_cents);
     gorilla->setAmount(2_cents);
+    add(account);
+    add(account);
     assertEqual(result, 1_cents + 2_cents, account.balance());
   });
 }
@@ -38,6 +38,13 @@ void notifiesObserverOfIncreasedAllocation(testcpplite::TestResult &);
 void notifiesObserverOfDecreasedAllocation(testcpplite::TestResult &);
 void notifiesObserverOfLoadedAllocation(testcpplite::TestResult &);
 void doesNotRemoveArchivedTransaction(testcpplite::TestResult &);
+void removesTransactionById(testcpplite::TestResult &);
+void updatesTransactionById(testcpplite::TestResult &);
+void releasesTransactionById(testcpplite::TestResult &);
+void adoptsTransaction(testcpplite::TestResult &);
+void verifiesTransactionById(testcpplite::TestResult &);
+void doesNotRemoveArchivedTransactionById(testcpplite::TestResult &);
+void rejectsTransactionWithIdInUse(testcpplite::TestResult &);
 } // namespace sbash64::budget::account
 
 #endif
@@ -0,0 +1,81 @@
+#include "allocations.hpp"
+
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/allocations.hpp>
+#include <sbash64/budget/format.hpp>
+#include <sbash64/budget/protocol.hpp>
+#include <sbash64/budget/serialization.hpp>
+#include <sbash64/budget/transaction.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+
+// Allocation budgets for hot paths. Raise one only with a reason.
+namespace sbash64::budget::allocations {
+// Where an allocation escapes to, so that the compiler can't leave it out.
+static void *volatile sink;
+
+void countsOnlyWhatFollows(testcpplite::TestResult &result) {
+  auto before{std::make_unique<std::string>(100, 'a')};
+  AllocationsSince since;
+  assertEqual(result, std::uint_least64_t{0}, since.allocations());
+  auto after{std::make_unique<int>(1)};
+  sink = after.get();
+  assertEqual(result, std::uint_least64_t{1}, since.allocations());
+  assertEqual(result, std::uint_least64_t{sizeof(int)}, since.bytes());
+}
+
+void allocatesAlignedZeroBytes(testcpplite::TestResult &result) {
+  constexpr std::align_val_t alignment{64};
+  AllocationsSince since;
+  void *const p{::operator new(0, alignment)};
+  assertTrue(result, p != nullptr);
+  assertEqual(result, std::uint_least64_t{1}, since.allocations());
+  ::operator delete(p, alignment);
+}
+
+// The transaction, its list node and its index node, besides the index's
+// growth.
+void accountAddsWithThreeAllocations(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory::Factory factory;
+  AccountInMemory account{factory};
+  constexpr auto transactions{1000};
+  AllocationsSince since;
+  for (auto i{0}; i < transactions; ++i)
+    account.add({USD{i}, "walmart", Date{2021, Month::March, 2}});
+  assertTrue(result, since.allocations() <= 3 * transactions + 32);
+}
+
+void transactionLoadsWithTwoAllocations(testcpplite::TestResult &result) {
+  std::istringstream stream{"12.34 walmart 3/2/2021\n"};
+  ReadsTransactionFromStream deserialization{stream};
+  AllocationsSince since;
+  deserialization.load();
+  assertTrue(result, since.allocations() <= 2);
+}
+
+void transactionRowIsWrittenWithoutAllocating(
+    testcpplite::TestResult &result) {
+  MessageBatch batch;
+  JsonView view{batch};
+  const auto addRow{[&view] {
+    view.addTransactionRow(1, USD{1234}, Date{2021, Month::March, 2},
+                           "walmart", 3, TransactionId{9});
+  }};
+  addRow();
+  batch.clear();
+  AllocationsSince since;
+  addRow();
+  assertEqual(result, std::uint_least64_t{0}, since.allocations());
+}
+
+void usdIsFormattedWithoutAllocating(testcpplite::TestResult &result) {
+  std::ostringstream stream{std::string(64, ' ')};
+  AllocationsSince since;
+  stream << USD{123456};
+  assertEqual(result, std::uint_least64_t{0}, since.allocations());
+}
+} // namespace sbash64::budget::allocations
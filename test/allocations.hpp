@@ -0,0 +1,15 @@
+#ifndef SBASH64_BUDGET_TEST_ALLOCATIONS_HPP_
+#define SBASH64_BUDGET_TEST_ALLOCATIONS_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::allocations {
+void countsOnlyWhatFollows(testcpplite::TestResult &);
+void allocatesAlignedZeroBytes(testcpplite::TestResult &);
+void accountAddsWithThreeAllocations(testcpplite::TestResult &);
+void transactionLoadsWithTwoAllocations(testcpplite::TestResult &);
+void transactionRowIsWrittenWithoutAllocating(testcpplite::TestResult &);
+void usdIsFormattedWithoutAllocating(testcpplite::TestResult &);
+} // namespace sbash64::budget::allocations
+
+#endif
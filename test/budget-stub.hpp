@@ -0,0 +1,135 @@
+#ifndef SBASH64_BUDGET_TEST_BUDGET_STUB_HPP_
+#define SBASH64_BUDGET_TEST_BUDGET_STUB_HPP_
+
+#include <sbash64/budget/domain.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace sbash64::budget {
+class BudgetStub : public Budget {
+public:
+  void attach(Observer &) override {}
+
+  void addIncome(const Transaction &t) override {
+    called("addIncome", {}, t);
+  }
+
+  void addExpense(std::string_view accountName, const Transaction &t) override {
+    called("addExpense", accountName, t);
+  }
+
+  void removeIncome(const Transaction &t) override {
+    called("removeIncome", {}, t);
+  }
+
+  void removeIncome(TransactionId id) override {
+    called("removeIncome");
+    transactionId = id;
+  }
+
+  void removeExpense(std::string_view accountName,
+                     const Transaction &t) override {
+    called("removeExpense", accountName, t);
+  }
+
+  void removeExpense(std::string_view accountName, TransactionId id) override {
+    called("removeExpense", accountName);
+    transactionId = id;
+  }
+
+  void verifyIncome(const Transaction &t) override {
+    called("verifyIncome", {}, t);
+  }
+
+  void verifyIncome(TransactionId id) override {
+    called("verifyIncome");
+    transactionId = id;
+  }
+
+  void verifyExpense(std::string_view accountName,
+                     const Transaction &t) override {
+    called("verifyExpense", accountName, t);
+  }
+
+  void verifyExpense(std::string_view accountName, TransactionId id) override {
+    called("verifyExpense", accountName);
+    transactionId = id;
+  }
+
+  void updateIncome(TransactionId id, const Transaction &t) override {
+    called("updateIncome", {}, t);
+    transactionId = id;
+  }
+
+  void updateExpense(std::string_view accountName, TransactionId id,
+                     const Transaction &t) override {
+    called("updateExpense", accountName, t);
+    transactionId = id;
+  }
+
+  void moveExpense(std::string_view from, std::string_view to,
+                   TransactionId id) override {
+    called("moveExpense", from);
+    newAccountName = to;
+    transactionId = id;
+  }
+
+  void transferTo(std::string_view accountName, USD usd) override {
+    called("transferTo", accountName);
+    amount = usd;
+  }
+
+  void allocate(std::string_view accountName, USD usd) override {
+    called("allocate", accountName);
+    amount = usd;
+  }
+
+  void createAccount(std::string_view name) override {
+    called("createAccount", name);
+  }
+
+  void removeAccount(std::string_view name) override {
+    called("removeAccount", name);
+  }
+
+  void renameAccount(std::string_view from, std::string_view to) override {
+    called("renameAccount", from);
+    newAccountName = to;
+  }
+
+  void closeAccount(std::string_view name) override {
+    called("closeAccount", name);
+  }
+
+  void restore() override { called("restore"); }
+
+  void reduce() override { called("reduce"); }
+
+  void save(BudgetSerialization &) override { called("save"); }
+
+  void load(BudgetDeserialization &) override { called("load"); }
+
+  void notifyThatIncomeAccountIsReady(AccountDeserialization &) override {}
+
+  void notifyThatExpenseAccountIsReady(AccountDeserialization &,
+                                       std::string_view) override {}
+
+  std::string method;
+  std::string accountName;
+  std::string newAccountName;
+  Transaction transaction{};
+  TransactionId transactionId{};
+  USD amount{};
+
+private:
+  void called(std::string_view method_, std::string_view accountName_ = {},
+              const Transaction &t = {}) {
+    method = method_;
+    accountName = accountName_;
+    transaction = t;
+  }
+};
+} // namespace sbash64::budget
+
+#endif
@@ -1,15 +1,20 @@
 #include "budget.hpp"
 #include "account-stub.hpp"
+#include "budget-stub.hpp"
 #include "persistent-memory-stub.hpp"
 #include "usd.hpp"
 
 #include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/transaction.hpp>
 #include <sbash64/testcpplite/testcpplite.hpp>
 
 #include <gsl/gsl>
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string_view>
 #include <vector>
 
@@ -59,6 +64,13 @@ public:
 
   auto netIncome() -> USD { return netIncome_; }
 
+  void notifyThatExpenseHasMoved(std::string_view from, std::string_view to,
+                                 TransactionId id) override {
+    movedFrom = from;
+    movedTo = to;
+    movedTransactionId = id;
+  }
+
   void notifyThatHasBeenSaved() override { saved_ = true; }
 
   [[nodiscard]] auto saved() const -> bool { return saved_; }
@@ -69,6 +81,10 @@ public:
 
   void notifyThatHasUnsavedChanges() override { hasUnsavedChanges_ = true; }
 
+  std::string movedFrom;
+  std::string movedTo;
+  TransactionId movedTransactionId{};
+
 private:
   std::map<std::string, std::vector<USD>> categoryAllocations_;
   std::vector<USD> unallocatedIncome_;
@@ -383,6 +399,15 @@ void removesExpenseFromAccount(testcpplite::TestResult &result) {
   });
 }
 
+void removesExpenseFromAccountById(testcpplite::TestResult &result) {
+  testBudgetInMemory([&result](AccountFactoryStub &factory, AccountStub &,
+                               Budget &budget) {
+    const auto account{createAccountStub(budget, factory, "giraffe")};
+    budget.removeExpense("giraffe", TransactionId{7});
+    assertEqual(result, TransactionId{7}, account->removedTransactionId);
+  });
+}
+
 void notifiesThatHasUnsavedChangesWhenRemovingExpense(
     testcpplite::TestResult &result) {
   testBudgetInMemory(
@@ -417,6 +442,14 @@ void removesIncomeFromAccount(testcpplite::TestResult &result) {
   });
 }
 
+void removesIncomeFromAccountById(testcpplite::TestResult &result) {
+  testBudgetInMemory([&result](AccountFactoryStub &, AccountStub &incomeAccount,
+                               Budget &budget) {
+    budget.removeIncome(TransactionId{7});
+    assertEqual(result, TransactionId{7}, incomeAccount.removedTransactionId);
+  });
+}
+
 void notifiesThatHasUnsavedChangesWhenRemovingIncome(
     testcpplite::TestResult &result) {
   testBudgetInMemory([&result](AccountFactoryStub &, AccountStub &,
@@ -470,6 +503,15 @@ void verifiesExpenseForExistingAccount(testcpplite::TestResult &result) {
       });
 }
 
+void verifiesExpenseById(testcpplite::TestResult &result) {
+  testBudgetInMemory(
+      [&result](AccountFactoryStub &factory, AccountStub &, Budget &budget) {
+        const auto giraffe{createAccountStub(budget, factory, "giraffe")};
+        budget.verifyExpense("giraffe", TransactionId{7});
+        assertEqual(result, TransactionId{7}, giraffe->verifiedTransactionId);
+      });
+}
+
 void ignoresVerificationOfNonexistentAccount(testcpplite::TestResult &) {
   testBudgetInMemory([](AccountFactoryStub &, AccountStub &, Budget &budget) {
     budget.verifyExpense("giraffe",
@@ -499,6 +541,73 @@ void verifiesIncome(testcpplite::TestResult &result) {
   });
 }
 
+void verifiesIncomeById(testcpplite::TestResult &result) {
+  testBudgetInMemory([&result](AccountFactoryStub &, AccountStub &incomeAccount,
+                               Budget &budget) {
+    budget.verifyIncome(TransactionId{7});
+    assertEqual(result, TransactionId{7}, incomeAccount.verifiedTransactionId);
+  });
+}
+
+void updatesExpenseById(testcpplite::TestResult &result) {
+  testBudgetInMemory(
+      [&result](AccountFactoryStub &factory, AccountStub &, Budget &budget) {
+        const auto giraffe{createAccountStub(budget, factory, "giraffe")};
+        BudgetObserverStub observer;
+        budget.attach(observer);
+        budget.updateExpense("giraffe", TransactionId{7},
+                             {1_cents, "hi", Date{2020, Month::April, 1}});
+        assertEqual(result, TransactionId{7}, giraffe->updatedTransactionId);
+        assertEqual(result, {1_cents, "hi", Date{2020, Month::April, 1}},
+                    giraffe->updatedTransaction);
+        assertHasUnsavedChanges(result, observer);
+      });
+}
+
+void updatesIncomeById(testcpplite::TestResult &result) {
+  testBudgetInMemory([&result](AccountFactoryStub &, AccountStub &incomeAccount,
+                               Budget &budget) {
+    budget.updateIncome(TransactionId{7},
+                        {1_cents, "hi", Date{2020, Month::April, 1}});
+    assertEqual(result, TransactionId{7}, incomeAccount.updatedTransactionId);
+    assertEqual(result, {1_cents, "hi", Date{2020, Month::April, 1}},
+                incomeAccount.updatedTransaction);
+  });
+}
+
+void movesExpenseById(testcpplite::TestResult &result) {
+  testBudgetInMemory(
+      [&result](AccountFactoryStub &factory, AccountStub &, Budget &budget) {
+        const auto giraffe{createAccountStub(budget, factory, "giraffe")};
+        const auto penguin{createAccountStub(budget, factory, "penguin")};
+        BudgetObserverStub observer;
+        budget.attach(observer);
+        giraffe->releasedTransaction =
+            std::make_shared<ObservableTransactionInMemory>();
+        budget.moveExpense("giraffe", "penguin", TransactionId{7});
+        assertEqual(result, TransactionId{7}, giraffe->releasedTransactionId);
+        assertTrue(result,
+                   giraffe->releasedTransaction == penguin->adoptedTransaction);
+        assertEqual(result, "giraffe", observer.movedFrom);
+        assertEqual(result, "penguin", observer.movedTo);
+        assertEqual(result, TransactionId{7}, observer.movedTransactionId);
+        assertHasUnsavedChanges(result, observer);
+      });
+}
+
+void ignoresMoveOfUnknownExpense(testcpplite::TestResult &result) {
+  testBudgetInMemory(
+      [&result](AccountFactoryStub &factory, AccountStub &, Budget &budget) {
+        createAccountStub(budget, factory, "giraffe");
+        const auto penguin{createAccountStub(budget, factory, "penguin")};
+        BudgetObserverStub observer;
+        budget.attach(observer);
+        budget.moveExpense("giraffe", "penguin", TransactionId{7});
+        assertTrue(result, penguin->adoptedTransaction == nullptr);
+        assertFalse(result, observer.hasUnsavedChanges());
+      });
+}
+
 void notifiesThatHasUnsavedChangesWhenVerifyingIncome(
     testcpplite::TestResult &result) {
   testBudgetInMemory([&result](AccountFactoryStub &, AccountStub &,
@@ -771,4 +880,38 @@ void restoresAccountsHavingNegativeBalances(testcpplite::TestResult &result) {
                 leopard->increasedAllocationAmount());
   });
 }
+
+void instrumentedBudgetForwardsCalls(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  InstrumentedBudget instrumented{budget};
+  instrumented.verifyExpense("giraffe", TransactionId{7});
+  assertEqual(result, "verifyExpense", budget.method);
+  assertEqual(result, "giraffe", budget.accountName);
+  assertEqual(result, TransactionId{7}, budget.transactionId);
+  instrumented.moveExpense("giraffe", "penguin", TransactionId{8});
+  assertEqual(result, "moveExpense", budget.method);
+  assertEqual(result, "penguin", budget.newAccountName);
+  assertEqual(result, TransactionId{8}, budget.transactionId);
+}
+
+void instrumentedBudgetCountsCallsByOperation(
+    testcpplite::TestResult &result) {
+  BudgetStub budget;
+  InstrumentedBudget instrumented{budget};
+  instrumented.removeIncome(TransactionId{1});
+  instrumented.removeIncome(Transaction{1_cents, "hi", Date{}});
+  instrumented.reduce();
+  const auto counts{instrumented.snapshot()};
+  const auto calls{[&counts](std::string_view operation) {
+    return std::find_if(counts.begin(), counts.end(),
+                        [operation](const InstrumentedBudget::Count &count) {
+                          return count.operation == operation;
+                        })
+        ->calls;
+  }};
+  assertEqual(result, std::uint_least64_t{2}, calls("removeIncome"));
+  assertEqual(result, std::uint_least64_t{1}, calls("reduce"));
+  assertEqual(result, std::uint_least64_t{0}, calls("save"));
+  assertEqual(result, "load", counts.back().operation);
+}
 } // namespace sbash64::budget
@@ -53,6 +53,16 @@ void notifiesThatHasUnsavedChangesWhenClosingAccount(testcpplite::TestResult &);
 void notifiesThatHasUnsavedChangesWhenAllocating(testcpplite::TestResult &);
 void notifiesThatHasUnsavedChangesWhenCreatingAccount(
     testcpplite::TestResult &);
+void removesExpenseFromAccountById(testcpplite::TestResult &);
+void removesIncomeFromAccountById(testcpplite::TestResult &);
+void verifiesExpenseById(testcpplite::TestResult &);
+void verifiesIncomeById(testcpplite::TestResult &);
+void updatesExpenseById(testcpplite::TestResult &);
+void updatesIncomeById(testcpplite::TestResult &);
+void movesExpenseById(testcpplite::TestResult &);
+void ignoresMoveOfUnknownExpense(testcpplite::TestResult &);
+void instrumentedBudgetForwardsCalls(testcpplite::TestResult &);
+void instrumentedBudgetCountsCallsByOperation(testcpplite::TestResult &);
 } // namespace sbash64::budget
 
 #endif
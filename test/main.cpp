@@ -1,9 +1,17 @@
 #include "account.hpp"
+#include "allocations.hpp"
 #include "budget.hpp"
 #include "format.hpp"
+#include "memory.hpp"
+#include "metrics.hpp"
 #include "parse.hpp"
 #include "presentation.hpp"
+#include "protocol.hpp"
+#include "queue.hpp"
+#include "ranked.hpp"
+#include "recording.hpp"
 #include "stream.hpp"
+#include "trace.hpp"
 #include "transaction.hpp"
 
 #include <sbash64/testcpplite/testcpplite.hpp>
@@ -51,6 +59,18 @@ static auto runAllTests() -> int {
         "creates account when debiting nonexistent"},
        {addsExpenseToExistingAccount, "debits existing account"},
        {removesExpenseFromAccount, "removes transactions from accounts"},
+       {removesExpenseFromAccountById, "removes debit from account by id"},
+       {removesIncomeFromAccountById,
+        "removes credit from master account by id"},
+       {verifiesExpenseById, "verifies debit by id"},
+       {verifiesIncomeById, "verifies credit for master account by id"},
+       {updatesExpenseById, "updates debit by id"},
+       {updatesIncomeById, "updates credit for master account by id"},
+       {movesExpenseById, "moves debit between accounts by id"},
+       {ignoresMoveOfUnknownExpense, "does nothing when moving unknown debit"},
+       {instrumentedBudgetForwardsCalls, "instrumented budget forwards calls"},
+       {instrumentedBudgetCountsCallsByOperation,
+        "instrumented budget counts calls by operation"},
        {verifiesExpenseForExistingAccount,
         "verifies debit for existing account"},
        {ignoresVerificationOfNonexistentAccount,
@@ -158,6 +178,16 @@ static auto runAllTests() -> int {
         "account::verifiesLoadedTransaction"},
        {account::archivesLoadedTransaction,
         "account::archivesLoadedTransaction"},
+       {account::removesTransactionById, "account::removesTransactionById"},
+       {account::updatesTransactionById, "account::updatesTransactionById"},
+       {account::releasesTransactionById,
+        "account::releasesTransactionById"},
+       {account::adoptsTransaction, "account::adoptsTransaction"},
+       {account::verifiesTransactionById, "account::verifiesTransactionById"},
+       {account::doesNotRemoveArchivedTransactionById,
+        "account::doesNotRemoveArchivedTransactionById"},
+       {account::rejectsTransactionWithIdInUse,
+        "account::rejectsTransactionWithIdInUse"},
        {transaction::notifiesObserverOfInitializedTransaction,
         "notifiesThatIsAfterInitialize"},
        {transaction::notifiesObserverOfRemovalByQuery,
@@ -183,14 +213,27 @@ static auto runAllTests() -> int {
         "transaction removesInitializedTransaction"},
        {transaction::doesNotVerifyUnequalInitializedTransaction,
         "transaction doesNotVerifyUnequalInitializedTransaction"},
-       {presentation::formatsTransactionAmount,
-        "presentation::formatsTransactionAmount"},
-       {presentation::formatsTransactionDate, "presentation::formatsDate"},
-       {presentation::formatsAccountBalance, "presentation::formatsBalance"},
-       {presentation::formatsAccountAllocation,
-        "presentation::formatsAllocation"},
+       {transaction::verifiesOnce, "transaction::verifiesOnce"},
+       {transaction::updatesKeepingVerification,
+        "transaction::updatesKeepingVerification"},
+       {transaction::makesTransactionsWithDistinctIds,
+        "transaction::makesTransactionsWithDistinctIds"},
+       {presentation::passesTransactionAmount,
+        "presentation::passesTransactionAmount"},
+       {presentation::passesTransactionDate,
+        "presentation::passesTransactionDate"},
+       {presentation::passesAccountBalance,
+        "presentation::passesAccountBalance"},
+       {presentation::passesAccountAllocation,
+        "presentation::passesAccountAllocation"},
        {presentation::passesDescriptionOfNewTransaction,
         "presentation::sendsDescriptionOfNewTransaction"},
+       {presentation::passesIdOfNewTransaction,
+        "presentation::passesIdOfNewTransaction"},
+       {presentation::repositionsUpdatedTransaction,
+        "presentation::repositionsUpdatedTransaction"},
+       {presentation::movesTransactionRowBetweenAccounts,
+        "presentation::movesTransactionRowBetweenAccounts"},
        {presentation::ordersTransactionsByMostRecentDate,
         "presentation::ordersTransactionsByMostRecentDate"},
        {presentation::ordersSameDateTransactionsByDescription,
@@ -205,9 +248,114 @@ static auto runAllTests() -> int {
         "presentation::ordersAccountsByName"},
        {presentation::reordersAccountsByName,
         "presentation::reordersAccountsByName"},
-       {presentation::formatsNetIncome, "presentation::formatsNetIncome"},
+       {presentation::passesNetIncome, "presentation::passesNetIncome"},
        {presentation::marksAsSaved, "presentation::marksAsSaved"},
-       {presentation::marksAsUnsaved, "presentation::marksAsUnsaved"}},
+       {presentation::marksAsUnsaved, "presentation::marksAsUnsaved"},
+       {presentation::catchesUpViewWithoutNotifyingItLater,
+        "presentation::catchesUpViewWithoutNotifyingItLater"},
+       {presentation::notifiesAttachedViewWithoutCatchingItUp,
+        "presentation::notifiesAttachedViewWithoutCatchingItUp"},
+       {protocol::writesTransactionRow, "protocol::writesTransactionRow"},
+       {protocol::writesTransactionRowUpdate,
+        "protocol::writesTransactionRowUpdate"},
+       {protocol::writesTransactionRowMove,
+        "protocol::writesTransactionRowMove"},
+       {protocol::writesMessageWithoutFields,
+        "protocol::writesMessageWithoutFields"},
+       {protocol::escapesDescription, "protocol::escapesDescription"},
+       {protocol::replacesInvalidUtf8, "protocol::replacesInvalidUtf8"},
+       {protocol::writesEachMessageOfFrame,
+        "protocol::writesEachMessageOfFrame"},
+       {protocol::keepsLatestBalanceOfEachAccount,
+        "protocol::keepsLatestBalanceOfEachAccount"},
+       {protocol::keepsLatestSavedState, "protocol::keepsLatestSavedState"},
+       {protocol::keepsBalancesAcrossAccountIndexChange,
+        "protocol::keepsBalancesAcrossAccountIndexChange"},
+       {protocol::reusesBufferAfterClear, "protocol::reusesBufferAfterClear"},
+       {protocol::coalescesAppendedBatches,
+        "protocol::coalescesAppendedBatches"},
+       {protocol::dropsBytesOfSupersededMessages,
+        "protocol::dropsBytesOfSupersededMessages"},
+       {protocol::formatsAmountsLikeStreams,
+        "protocol::formatsAmountsLikeStreams"},
+       {protocol::packsTransactionRow, "protocol::packsTransactionRow"},
+       {protocol::packsNegativeAmounts, "protocol::packsNegativeAmounts"},
+       {protocol::packsLongStrings, "protocol::packsLongStrings"},
+       {protocol::writesFrameHeader, "protocol::writesFrameHeader"},
+       {protocol::packsFrameHeader, "protocol::packsFrameHeader"},
+       {protocol::parsesTransactionCommand,
+        "protocol::parsesTransactionCommand"},
+       {protocol::parsesDateFromDateInput,
+        "protocol::parsesDateFromDateInput"},
+       {protocol::unescapesStrings, "protocol::unescapesStrings"},
+       {protocol::ignoresUnknownFields, "protocol::ignoresUnknownFields"},
+       {protocol::decodesMalformedCommandAsUnknown,
+        "protocol::decodesMalformedCommandAsUnknown"},
+       {protocol::recognizesEachMethod, "protocol::recognizesEachMethod"},
+       {protocol::namesEachMethod, "protocol::namesEachMethod"},
+       {protocol::appliesIncomeTransaction,
+        "protocol::appliesIncomeTransaction"},
+       {protocol::appliesExpenseTransaction,
+        "protocol::appliesExpenseTransaction"},
+       {protocol::appliesRename, "protocol::appliesRename"},
+       {protocol::appliesTransfer, "protocol::appliesTransfer"},
+       {protocol::appliesTransactionById, "protocol::appliesTransactionById"},
+       {protocol::appliesIncomeTransactionById,
+        "protocol::appliesIncomeTransactionById"},
+       {protocol::appliesTransactionUpdate,
+        "protocol::appliesTransactionUpdate"},
+       {protocol::appliesTransactionMove, "protocol::appliesTransactionMove"},
+       {allocations::countsOnlyWhatFollows,
+        "allocations::countsOnlyWhatFollows"},
+       {allocations::allocatesAlignedZeroBytes,
+        "allocations::allocatesAlignedZeroBytes"},
+       {allocations::accountAddsWithThreeAllocations,
+        "allocations::accountAddsWithThreeAllocations"},
+       {allocations::transactionLoadsWithTwoAllocations,
+        "allocations::transactionLoadsWithTwoAllocations"},
+       {allocations::transactionRowIsWrittenWithoutAllocating,
+        "allocations::transactionRowIsWrittenWithoutAllocating"},
+       {allocations::usdIsFormattedWithoutAllocating,
+        "allocations::usdIsFormattedWithoutAllocating"},
+       {recording::readsWhatWasWritten, "recording::readsWhatWasWritten"},
+       {recording::keepsTimesFromGoingBackward,
+        "recording::keepsTimesFromGoingBackward"},
+       {recording::stopsAtPayloadCutShort, "recording::stopsAtPayloadCutShort"},
+       {recording::rejectsOtherStreams, "recording::rejectsOtherStreams"},
+       {recording::writesSmallPayloadsCompactly,
+        "recording::writesSmallPayloadsCompactly"},
+       {trace::nestsSpansByThread, "trace::nestsSpansByThread"},
+       {trace::keepsLatestSpans, "trace::keepsLatestSpans"},
+       {trace::keepsLatestSpansOfEachThread,
+        "trace::keepsLatestSpansOfEachThread"},
+       {trace::logsSlowSpanWithDescendants,
+        "trace::logsSlowSpanWithDescendants"},
+       {trace::logsNothingWhenFast, "trace::logsNothingWhenFast"},
+       {trace::writesChromeTrace, "trace::writesChromeTrace"},
+       {memory::countsOnlyLongStrings, "memory::countsOnlyLongStrings"},
+       {memory::countsLongDescriptions, "memory::countsLongDescriptions"},
+       {memory::countsArchivedTransactionsApart,
+        "memory::countsArchivedTransactionsApart"},
+       {memory::countsPresentersByAccount, "memory::countsPresentersByAccount"},
+       {memory::writesReport, "memory::writesReport"},
+       {metrics::hasNoQuantileWhenEmpty, "metrics::hasNoQuantileWhenEmpty"},
+       {metrics::keepsShortDurationsExact,
+        "metrics::keepsShortDurationsExact"},
+       {metrics::keepsQuantilesWithinAnEighth,
+        "metrics::keepsQuantilesWithinAnEighth"},
+       {metrics::countsLongDurationsInLastBucket,
+        "metrics::countsLongDurationsInLastBucket"},
+       {metrics::sumsAndCounts, "metrics::sumsAndCounts"},
+       {metrics::writesPrometheusSample, "metrics::writesPrometheusSample"},
+       {metrics::writesPrometheusSummary, "metrics::writesPrometheusSummary"},
+       {queue::popsInPushOrder, "queue::popsInPushOrder"},
+       {queue::popsNothingWhenEmpty, "queue::popsNothingWhenEmpty"},
+       {queue::popsEveryValueOfConcurrentProducers,
+        "queue::popsEveryValueOfConcurrentProducers"},
+       {ranked::ranksInOrder, "ranked::ranksInOrder"},
+       {ranked::visitsInOrder, "ranked::visitsInOrder"},
+       {ranked::ranksNothingExtracted, "ranked::ranksNothingExtracted"},
+       {ranked::extractsNothingAbsent, "ranked::extractsNothingAbsent"}},
       std::cout);
 }
 } // namespace sbash64::budget
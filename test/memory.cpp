@@ -0,0 +1,77 @@
+#include "memory.hpp"
+
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/memory.hpp>
+#include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/transaction.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace sbash64::budget::memory {
+void countsOnlyLongStrings(testcpplite::TestResult &result) {
+  const std::string shortString{"walmart"};
+  assertEqual(result, std::size_t{0}, heapBytes(shortString));
+  const std::string longString(100, 'a');
+  assertTrue(result, heapBytes(longString) >= 101);
+}
+
+void countsLongDescriptions(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory::Factory factory;
+  AccountInMemory account{factory};
+  account.add({USD{1}, "walmart", Date{2021, Month::March, 2}});
+  const auto shortOnly{account.memory()};
+  assertEqual(result, std::size_t{0}, shortOnly.descriptions);
+  account.add({USD{2}, std::string(100, 'a'), Date{2021, Month::March, 2}});
+  const auto memory{account.memory()};
+  assertTrue(result, memory.descriptions >= 101);
+  assertTrue(result, memory.transactions >
+                         shortOnly.transactions +
+                             sizeof(ObservableTransactionInMemory));
+  assertEqual(result, std::size_t{0}, memory.archivedTransactions);
+}
+
+void countsArchivedTransactionsApart(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory::Factory factory;
+  AccountInMemory account{factory};
+  account.add({USD{1}, "walmart", Date{2021, Month::March, 2}});
+  account.add({USD{2}, "target", Date{2021, Month::March, 3}});
+  account.verify(TransactionId{1});
+  account.increaseAllocationByResolvingVerifiedTransactions();
+  assertTrue(result, account.memory().archivedTransactions >=
+                         sizeof(ObservableTransactionInMemory));
+}
+
+void countsPresentersByAccount(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount{transactionFactory};
+  AccountInMemory::Factory accountFactory{transactionFactory};
+  BudgetInMemory budget{incomeAccount, accountFactory};
+  BudgetPresenter presenter{incomeAccount};
+  budget.attach(presenter);
+  budget.addIncome({USD{1}, "paycheck", Date{2021, Month::March, 2}});
+  budget.addExpense("Gifts", {USD{2}, std::string(100, 'a'),
+                              Date{2021, Month::March, 3}});
+  const auto reports{memoryReport(incomeAccount, budget, presenter)};
+  assertEqual(result, std::size_t{2}, reports.size());
+  assertEqual(result, "Income", reports.at(0).name);
+  assertTrue(result, reports.at(0).presenter.transactions >=
+                         sizeof(TransactionPresenter));
+  assertEqual(result, std::size_t{0}, reports.at(0).presenter.descriptions);
+  assertEqual(result, "Gifts", reports.at(1).name);
+  assertTrue(result, reports.at(1).account.descriptions >= 101);
+  assertTrue(result, reports.at(1).presenter.descriptions >= 101);
+}
+
+void writesReport(testcpplite::TestResult &result) {
+  std::string out;
+  writeMemoryReport(out, {{"Income", {1, 2, 3, 4}, {5, 6}},
+                          {"Gifts", {10, 0, 0, 0}, {0, 0}}});
+  assertEqual(
+      result,
+      R"({"total":31,"accounts":[{"name":"Income","total":21,"transactions":1,"archivedTransactions":2,"descriptions":3,"observers":4,"presenterTransactions":5,"presenterDescriptions":6},)"
+      R"({"name":"Gifts","total":10,"transactions":10,"archivedTransactions":0,"descriptions":0,"observers":0,"presenterTransactions":0,"presenterDescriptions":0}]})",
+      out);
+}
+} // namespace sbash64::budget::memory
@@ -0,0 +1,14 @@
+#ifndef SBASH64_BUDGET_TEST_MEMORY_HPP_
+#define SBASH64_BUDGET_TEST_MEMORY_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::memory {
+void countsOnlyLongStrings(testcpplite::TestResult &);
+void countsLongDescriptions(testcpplite::TestResult &);
+void countsArchivedTransactionsApart(testcpplite::TestResult &);
+void countsPresentersByAccount(testcpplite::TestResult &);
+void writesReport(testcpplite::TestResult &);
+} // namespace sbash64::budget::memory
+
+#endif
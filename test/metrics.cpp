@@ -0,0 +1,79 @@
+#include "metrics.hpp"
+
+#include <sbash64/budget/metrics.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace sbash64::budget::metrics {
+using namespace std::chrono_literals;
+
+void hasNoQuantileWhenEmpty(testcpplite::TestResult &result) {
+  LatencyHistogram histogram;
+  assertTrue(result, histogram.quantile(.5) == 0ns);
+  assertEqual(result, std::uint_least64_t{0}, histogram.count());
+}
+
+void keepsShortDurationsExact(testcpplite::TestResult &result) {
+  LatencyHistogram histogram;
+  histogram.record(3ns);
+  histogram.record(5ns);
+  assertTrue(result, histogram.quantile(.5) == 3ns);
+  assertTrue(result, histogram.quantile(1) == 5ns);
+}
+
+void keepsQuantilesWithinAnEighth(testcpplite::TestResult &result) {
+  LatencyHistogram histogram;
+  for (auto i{1}; i <= 1000; ++i)
+    histogram.record(std::chrono::microseconds{i});
+  const auto median{histogram.quantile(.5)};
+  assertTrue(result, median >= 500us && median <= 500us + 500us / 8);
+  const auto p99{histogram.quantile(.99)};
+  assertTrue(result, p99 >= 990us && p99 <= 990us + 990us / 8);
+}
+
+void countsLongDurationsInLastBucket(testcpplite::TestResult &result) {
+  LatencyHistogram histogram;
+  histogram.record(10min);
+  assertEqual(result, std::uint_least64_t{1}, histogram.count());
+  assertTrue(result, histogram.quantile(1) >= 60s);
+}
+
+void sumsAndCounts(testcpplite::TestResult &result) {
+  LatencyHistogram histogram;
+  histogram.record(2ms);
+  histogram.record(3ms);
+  assertEqual(result, std::uint_least64_t{2}, histogram.count());
+  assertTrue(result, histogram.sum() == 5ms);
+}
+
+void writesPrometheusSample(testcpplite::TestResult &result) {
+  std::string out;
+  writePrometheusHeader(out, "sent_bytes_total", "counter", "Bytes sent.");
+  writePrometheusSample(out, "sent_bytes_total", "", 1024);
+  writePrometheusSample(out, "sent_bytes_total", R"(encoding="json")", 1.5);
+  assertEqual(result,
+              "# HELP sent_bytes_total Bytes sent.\n"
+              "# TYPE sent_bytes_total counter\n"
+              "sent_bytes_total 1024\n"
+              "sent_bytes_total{encoding=\"json\"} 1.5\n",
+              out);
+}
+
+void writesPrometheusSummary(testcpplite::TestResult &result) {
+  LatencyHistogram histogram;
+  histogram.record(4ns);
+  std::string out;
+  writePrometheusSummary(out, "command_seconds", R"(method="save")",
+                         histogram);
+  assertEqual(result,
+              "command_seconds{method=\"save\",quantile=\"0.5\"} 4e-09\n"
+              "command_seconds{method=\"save\",quantile=\"0.9\"} 4e-09\n"
+              "command_seconds{method=\"save\",quantile=\"0.99\"} 4e-09\n"
+              "command_seconds{method=\"save\",quantile=\"0.999\"} 4e-09\n"
+              "command_seconds_sum{method=\"save\"} 4e-09\n"
+              "command_seconds_count{method=\"save\"} 1\n",
+              out);
+}
+} // namespace sbash64::budget::metrics
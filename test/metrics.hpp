@@ -0,0 +1,16 @@
+#ifndef SBASH64_BUDGET_TEST_METRICS_HPP_
+#define SBASH64_BUDGET_TEST_METRICS_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::metrics {
+void hasNoQuantileWhenEmpty(testcpplite::TestResult &);
+void keepsShortDurationsExact(testcpplite::TestResult &);
+void keepsQuantilesWithinAnEighth(testcpplite::TestResult &);
+void countsLongDurationsInLastBucket(testcpplite::TestResult &);
+void sumsAndCounts(testcpplite::TestResult &);
+void writesPrometheusSample(testcpplite::TestResult &);
+void writesPrometheusSummary(testcpplite::TestResult &);
+} // namespace sbash64::budget::metrics
+
+#endif
@@ -16,21 +16,19 @@ class ViewStub : public View {
 public:
   void setAccountName(gsl::index, std::string_view) override {}
 
-  void updateAccountAllocation(gsl::index accountIndex,
-                               std::string_view s) override {
+  void updateAccountAllocation(gsl::index accountIndex, USD usd) override {
     accountIndex_ = static_cast<int>(accountIndex);
-    allocation_ = s;
+    allocation_ = usd;
   }
 
-  auto allocation() -> std::string { return allocation_; }
+  [[nodiscard]] auto allocation() const -> USD { return allocation_; }
 
-  void updateAccountBalance(gsl::index accountIndex,
-                            std::string_view s) override {
+  void updateAccountBalance(gsl::index accountIndex, USD usd) override {
     accountIndex_ = static_cast<int>(accountIndex);
-    balance_ = s;
+    balance_ = usd;
   }
 
-  auto balance() -> std::string { return balance_; }
+  [[nodiscard]] auto balance() const -> USD { return balance_; }
 
   void putCheckmarkNextToTransactionRow(gsl::index accountIndex,
                                         gsl::index index) override {
@@ -44,6 +42,26 @@ public:
     transactionDeleted_ = static_cast<int>(index);
   }
 
+  void updateTransactionRow(gsl::index accountIndex, gsl::index index,
+                            gsl::index newIndex, USD amount, const Date &date,
+                            std::string_view description) override {
+    accountIndex_ = static_cast<int>(accountIndex);
+    transactionUpdatedIndex = index;
+    transactionUpdatedNewIndex = newIndex;
+    transactionUpdatedAmount = amount;
+    transactionUpdatedDate = date;
+    transactionUpdatedDescription = description;
+  }
+
+  void moveTransactionRow(gsl::index accountIndex, gsl::index index,
+                          gsl::index newAccountIndex,
+                          gsl::index newIndex) override {
+    transactionMovedFromAccountIndex = accountIndex;
+    transactionMovedFromIndex = index;
+    transactionMovedToAccountIndex = newAccountIndex;
+    transactionMovedToIndex = newIndex;
+  }
+
   [[nodiscard]] auto transactionDeleted() const -> int {
     return transactionDeleted_;
   }
@@ -56,24 +74,27 @@ public:
     return transactionIndex_;
   }
 
-  auto transactionAddedAmount() -> std::string {
+  [[nodiscard]] auto transactionAddedAmount() const -> USD {
     return transactionAddedAmount_;
   }
 
-  auto transactionAddedDate() -> std::string { return transactionAddedDate_; }
+  [[nodiscard]] auto transactionAddedDate() const -> Date {
+    return transactionAddedDate_;
+  }
 
   auto transactionAddedDescription() -> std::string {
     return transactionAddedDescription_;
   }
 
-  void addTransactionRow(gsl::index accountIndex, std::string_view amount,
-                         std::string_view date, std::string_view description,
-                         gsl::index index) override {
+  void addTransactionRow(gsl::index accountIndex, USD amount,
+                         const Date &date, std::string_view description,
+                         gsl::index index, TransactionId id) override {
     accountIndex_ = static_cast<int>(accountIndex);
     transactionAddedAmount_ = amount;
     transactionAddedDate_ = date;
     transactionAddedDescription_ = description;
     transactionIndex_ = static_cast<int>(index);
+    transactionAddedId = id;
   }
 
   [[nodiscard]] auto removedTransactionSelectionIndex() const -> int {
@@ -97,9 +118,9 @@ public:
 
   auto newAccountName() -> std::string { return newAccountName_; }
 
-  auto netIncome() -> std::string { return netIncome_; }
+  [[nodiscard]] auto netIncome() const -> USD { return netIncome_; }
 
-  void updateNetIncome(std::string_view s) override { netIncome_ = s; }
+  void updateNetIncome(USD usd) override { netIncome_ = usd; }
 
   [[nodiscard]] auto accountIndex() const -> int { return accountIndex_; }
 
@@ -118,17 +139,27 @@ public:
     reorderedAccountToIndex = to;
   }
 
+  TransactionId transactionAddedId{};
+  gsl::index transactionUpdatedIndex{-1};
+  gsl::index transactionUpdatedNewIndex{-1};
+  USD transactionUpdatedAmount{};
+  Date transactionUpdatedDate{};
+  std::string transactionUpdatedDescription;
+  gsl::index transactionMovedFromAccountIndex{-1};
+  gsl::index transactionMovedFromIndex{-1};
+  gsl::index transactionMovedToAccountIndex{-1};
+  gsl::index transactionMovedToIndex{-1};
   gsl::index reorderedAccountFromIndex{-1};
   gsl::index reorderedAccountToIndex{-1};
 
 private:
-  std::string allocation_;
-  std::string balance_;
-  std::string transactionAddedAmount_;
-  std::string transactionAddedDate_;
+  USD allocation_{};
+  USD balance_{};
+  USD transactionAddedAmount_{};
+  Date transactionAddedDate_{};
   std::string transactionAddedDescription_;
   std::string newAccountName_;
-  std::string netIncome_;
+  USD netIncome_{};
   int transactionIndex_{-1};
   int accountIndex_{-1};
   int checkmarkTransactionIndex_{-1};
@@ -169,45 +200,46 @@ test(const std::function<void(AccountPresenter &, AccountStub &, ViewStub &,
   f(presenter, account, view, parent);
 }
 
-void formatsAccountBalance(testcpplite::TestResult &result) {
+void passesAccountBalance(testcpplite::TestResult &result) {
   test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
                  AccountPresenterParentStub &parent) {
     parent.index_ = 1;
     account.observer()->notifyThatBalanceHasChanged(123_cents);
-    assertEqual(result, "1.23", view.balance());
+    assertEqual(result, 123_cents, view.balance());
     assertEqual(result, 1, view.accountIndex());
   });
 }
 
-void formatsAccountAllocation(testcpplite::TestResult &result) {
+void passesAccountAllocation(testcpplite::TestResult &result) {
   test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
                  AccountPresenterParentStub &parent) {
     parent.index_ = 42;
     account.observer()->notifyThatAllocationHasChanged(4680_cents);
-    assertEqual(result, "46.80", view.allocation());
+    assertEqual(result, 4680_cents, view.allocation());
     assertEqual(result, 42, view.accountIndex());
   });
 }
 
-void formatsTransactionAmount(testcpplite::TestResult &result) {
+void passesTransactionAmount(testcpplite::TestResult &result) {
   test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
                  AccountPresenterParentStub &parent) {
     parent.index_ = 3;
     ObservableTransactionInMemory transaction;
     add(account, transaction,
         {{789_cents, "chimpanzee", Date{2020, Month::June, 1}}, false, false});
-    assertEqual(result, "7.89", view.transactionAddedAmount());
+    assertEqual(result, 789_cents, view.transactionAddedAmount());
     assertEqual(result, 3, view.accountIndex());
   });
 }
 
-void formatsTransactionDate(testcpplite::TestResult &result) {
+void passesTransactionDate(testcpplite::TestResult &result) {
   test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
                  AccountPresenterParentStub &) {
     ObservableTransactionInMemory transaction;
     add(account, transaction,
         {{789_cents, "chimpanzee", Date{2020, Month::June, 1}}, false, false});
-    assertEqual(result, "06/01/2020", view.transactionAddedDate());
+    assertEqual(result, Date{2020, Month::June, 1},
+                view.transactionAddedDate());
   });
 }
 
@@ -221,6 +253,40 @@ void passesDescriptionOfNewTransaction(testcpplite::TestResult &result) {
   });
 }
 
+void passesIdOfNewTransaction(testcpplite::TestResult &result) {
+  test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
+                 AccountPresenterParentStub &) {
+    ObservableTransactionInMemory transaction{42};
+    add(account, transaction,
+        {{789_cents, "chimpanzee", Date{2020, Month::June, 1}}, false, false});
+    assertEqual(result, TransactionId{42}, view.transactionAddedId);
+  });
+}
+
+void repositionsUpdatedTransaction(testcpplite::TestResult &result) {
+  test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
+                 AccountPresenterParentStub &parent) {
+    parent.index_ = 2;
+    ObservableTransactionInMemory june1st2020;
+    add(account, june1st2020,
+        {{789_cents, "chimpanzee", Date{2020, Month::June, 1}}, false, false});
+    ObservableTransactionInMemory january3rd2020;
+    add(account, january3rd2020,
+        {{789_cents, "chimpanzee", Date{2020, Month::January, 3}},
+         false,
+         false});
+    january3rd2020.update({123_cents, "gorilla", Date{2020, Month::July, 4}});
+    assertEqual(result, "chimpanzee", view.transactionAddedDescription());
+    assertEqual(result, 2, view.accountIndex());
+    assertEqual(result, gsl::index{1}, view.transactionUpdatedIndex);
+    assertEqual(result, gsl::index{0}, view.transactionUpdatedNewIndex);
+    assertEqual(result, 123_cents, view.transactionUpdatedAmount);
+    assertEqual(result, Date{2020, Month::July, 4},
+                view.transactionUpdatedDate);
+    assertEqual(result, "gorilla", view.transactionUpdatedDescription);
+  });
+}
+
 void ordersTransactionsByMostRecentDate(testcpplite::TestResult &result) {
   test([&result](AccountPresenter &, AccountStub &account, ViewStub &view,
                  AccountPresenterParentStub &) {
@@ -408,13 +474,40 @@ void ordersAccountsByName(testcpplite::TestResult &result) {
   assertEqual(result, 1, view.newAccountIndex());
 }
 
-void formatsNetIncome(testcpplite::TestResult &result) {
+void movesTransactionRowBetweenAccounts(testcpplite::TestResult &result) {
+  ViewStub view;
+  AccountStub incomeAccount;
+  BudgetPresenter presenter{incomeAccount};
+  presenter.add(&view);
+  AccountStub bob;
+  presenter.notifyThatExpenseAccountHasBeenCreated(bob, "bob");
+  AccountStub dale;
+  presenter.notifyThatExpenseAccountHasBeenCreated(dale, "dale");
+  ObservableTransactionInMemory june1st2020{1};
+  add(dale, june1st2020,
+      {{789_cents, "chimpanzee", Date{2020, Month::June, 1}}, false, false});
+  ObservableTransactionInMemory january3rd2020{2};
+  add(bob, january3rd2020,
+      {{789_cents, "chimpanzee", Date{2020, Month::January, 3}},
+       true,
+       false});
+  presenter.notifyThatExpenseHasMoved("bob", "dale", TransactionId{2});
+  assertEqual(result, gsl::index{1}, view.transactionMovedFromAccountIndex);
+  assertEqual(result, gsl::index{0}, view.transactionMovedFromIndex);
+  assertEqual(result, gsl::index{2}, view.transactionMovedToAccountIndex);
+  assertEqual(result, gsl::index{1}, view.transactionMovedToIndex);
+  january3rd2020.remove();
+  assertEqual(result, 2, view.accountIndex());
+  assertEqual(result, 1, view.transactionDeleted());
+}
+
+void passesNetIncome(testcpplite::TestResult &result) {
   ViewStub view;
   AccountStub incomeAccount;
   BudgetPresenter presenter{incomeAccount};
   presenter.add(&view);
   presenter.notifyThatNetIncomeHasChanged(1234_cents);
-  assertEqual(result, "12.34", view.netIncome());
+  assertEqual(result, 1234_cents, view.netIncome());
 }
 
 void marksAsSaved(testcpplite::TestResult &result) {
@@ -434,4 +527,26 @@ void marksAsUnsaved(testcpplite::TestResult &result) {
   presenter.notifyThatHasUnsavedChanges();
   assertTrue(result, view.markedAsUnsaved());
 }
+
+void catchesUpViewWithoutNotifyingItLater(testcpplite::TestResult &result) {
+  ViewStub view;
+  AccountStub incomeAccount;
+  BudgetPresenter presenter{incomeAccount};
+  presenter.notifyThatNetIncomeHasChanged(1234_cents);
+  presenter.catchUp(&view);
+  assertEqual(result, 1234_cents, view.netIncome());
+  presenter.notifyThatNetIncomeHasChanged(5678_cents);
+  assertEqual(result, 1234_cents, view.netIncome());
+}
+
+void notifiesAttachedViewWithoutCatchingItUp(testcpplite::TestResult &result) {
+  ViewStub view;
+  AccountStub incomeAccount;
+  BudgetPresenter presenter{incomeAccount};
+  presenter.notifyThatNetIncomeHasChanged(1234_cents);
+  presenter.attach(&view);
+  assertEqual(result, 0_cents, view.netIncome());
+  presenter.notifyThatNetIncomeHasChanged(5678_cents);
+  assertEqual(result, 5678_cents, view.netIncome());
+}
 } // namespace sbash64::budget::presentation
@@ -4,10 +4,10 @@
 #include <sbash64/testcpplite/testcpplite.hpp>
 
 namespace sbash64::budget::presentation {
-void formatsTransactionAmount(testcpplite::TestResult &);
-void formatsTransactionDate(testcpplite::TestResult &);
-void formatsAccountBalance(testcpplite::TestResult &);
-void formatsAccountAllocation(testcpplite::TestResult &);
+void passesTransactionAmount(testcpplite::TestResult &);
+void passesTransactionDate(testcpplite::TestResult &);
+void passesAccountBalance(testcpplite::TestResult &);
+void passesAccountAllocation(testcpplite::TestResult &);
 void passesDescriptionOfNewTransaction(testcpplite::TestResult &);
 void ordersTransactionsByMostRecentDate(testcpplite::TestResult &);
 void ordersSameDateTransactionsByDescription(testcpplite::TestResult &);
@@ -16,9 +16,14 @@ void deletesRemovedTransactionRow(testcpplite::TestResult &);
 void removesSelectionFromArchivedTransaction(testcpplite::TestResult &);
 void ordersAccountsByName(testcpplite::TestResult &);
 void reordersAccountsByName(testcpplite::TestResult &);
-void formatsNetIncome(testcpplite::TestResult &);
+void passesNetIncome(testcpplite::TestResult &);
 void marksAsSaved(testcpplite::TestResult &);
 void marksAsUnsaved(testcpplite::TestResult &);
+void catchesUpViewWithoutNotifyingItLater(testcpplite::TestResult &);
+void notifiesAttachedViewWithoutCatchingItUp(testcpplite::TestResult &);
+void passesIdOfNewTransaction(testcpplite::TestResult &);
+void repositionsUpdatedTransaction(testcpplite::TestResult &);
+void movesTransactionRowBetweenAccounts(testcpplite::TestResult &);
 } // namespace sbash64::budget::presentation
 
 #endif
@@ -0,0 +1,408 @@
+#include "protocol.hpp"
+#include "budget-stub.hpp"
+#include "usd.hpp"
+
+#include <sbash64/budget/protocol.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace sbash64::budget::protocol {
+static auto frame(const std::function<void(View &)> &f) -> std::string {
+  MessageBatch batch;
+  JsonView view{batch};
+  f(view);
+  std::string frame;
+  writeJsonFrame(frame, batch);
+  return frame;
+}
+
+void writesTransactionRow(testcpplite::TestResult &result) {
+  assertEqual(result,
+              R"([{"method":"add transaction row","accountIndex":1,)"
+              R"("transactionIndex":23,"transactionId":7,)"
+              R"("description":"hyvee","amount":"45.34","date":"04/03/2019"}])",
+              frame([](View &view) {
+                view.addTransactionRow(1, 4534_cents,
+                                       Date{2019, Month::April, 3}, "hyvee",
+                                       23, 7);
+              }));
+}
+
+void writesTransactionRowUpdate(testcpplite::TestResult &result) {
+  assertEqual(result,
+              R"([{"method":"update transaction row","accountIndex":1,)"
+              R"("transactionIndex":23,"newIndex":2,"description":"hyvee",)"
+              R"("amount":"45.34","date":"04/03/2019"}])",
+              frame([](View &view) {
+                view.updateTransactionRow(1, 23, 2, 4534_cents,
+                                          Date{2019, Month::April, 3},
+                                          "hyvee");
+              }));
+}
+
+void writesTransactionRowMove(testcpplite::TestResult &result) {
+  assertEqual(result,
+              R"([{"method":"move transaction row","accountIndex":1,)"
+              R"("transactionIndex":23,"newAccountIndex":4,"newIndex":2}])",
+              frame([](View &view) { view.moveTransactionRow(1, 23, 4, 2); }));
+}
+
+void writesMessageWithoutFields(testcpplite::TestResult &result) {
+  assertEqual(result, R"([{"method":"mark as saved"}])",
+              frame([](View &view) { view.markAsSaved(); }));
+}
+
+void escapesDescription(testcpplite::TestResult &result) {
+  assertEqual(result,
+              R"([{"method":"update account name","accountIndex":2,)"
+              R"("name":"\"a\\b\"\n\t\u0001 caf)"
+              "\xc3\xa9"
+              R"("}])",
+              frame([](View &view) {
+                view.setAccountName(2, "\"a\\b\"\n\t\x01 caf\xc3\xa9");
+              }));
+}
+
+void replacesInvalidUtf8(testcpplite::TestResult &result) {
+  assertEqual(result,
+              R"([{"method":"update account name","accountIndex":0,)"
+              R"("name":"a\ufffdb\ufffd"}])",
+              frame([](View &view) {
+                view.setAccountName(0, "a\xff"
+                                       "b\xc3");
+              }));
+}
+
+void writesEachMessageOfFrame(testcpplite::TestResult &result) {
+  assertEqual(result,
+              R"([{"method":"delete transaction row","accountIndex":3,)"
+              R"("transactionIndex":4},)"
+              R"({"method":"update net income","amount":"-1.00"}])",
+              frame([](View &view) {
+                view.deleteTransactionRow(3, 4);
+                view.updateNetIncome(USD{-100});
+              }));
+}
+
+void keepsLatestBalanceOfEachAccount(testcpplite::TestResult &result) {
+  assertEqual(
+      result,
+      R"([{"method":"update account balance","accountIndex":2,"amount":"2.00"},)"
+      R"({"method":"update account balance","accountIndex":1,"amount":"3.00"}])",
+      frame([](View &view) {
+        view.updateAccountBalance(1, 100_cents);
+        view.updateAccountBalance(2, 200_cents);
+        view.updateAccountBalance(1, 300_cents);
+      }));
+}
+
+void keepsLatestSavedState(testcpplite::TestResult &result) {
+  assertEqual(result, R"([{"method":"mark as unsaved"}])",
+              frame([](View &view) {
+                view.markAsUnsaved();
+                view.markAsSaved();
+                view.markAsUnsaved();
+              }));
+}
+
+void keepsBalancesAcrossAccountIndexChange(testcpplite::TestResult &result) {
+  assertEqual(
+      result,
+      R"([{"method":"update account balance","accountIndex":1,"amount":"1.00"},)"
+      R"({"method":"delete account table","accountIndex":1},)"
+      R"({"method":"update account balance","accountIndex":1,"amount":"3.00"}])",
+      frame([](View &view) {
+        view.updateAccountBalance(1, 100_cents);
+        view.deleteAccountTable(1);
+        view.updateAccountBalance(1, 300_cents);
+      }));
+}
+
+void reusesBufferAfterClear(testcpplite::TestResult &result) {
+  MessageBatch batch;
+  JsonView view{batch};
+  view.updateNetIncome(100_cents);
+  batch.clear();
+  assertTrue(result, batch.empty());
+  view.updateNetIncome(200_cents);
+  std::string frame;
+  writeJsonFrame(frame, batch);
+  assertEqual(result, R"([{"method":"update net income","amount":"2.00"}])",
+              frame);
+}
+
+void coalescesAppendedBatches(testcpplite::TestResult &result) {
+  MessageBatch pending;
+  MessageBatch batch;
+  JsonView view{batch};
+  view.updateNetIncome(100_cents);
+  view.deleteTransactionRow(1, 2);
+  pending.append(batch);
+  batch.clear();
+  view.updateNetIncome(200_cents);
+  pending.append(batch);
+  std::string frame;
+  writeJsonFrame(frame, pending);
+  assertEqual(result,
+              R"([{"method":"delete transaction row","accountIndex":1,)"
+              R"("transactionIndex":2},)"
+              R"({"method":"update net income","amount":"2.00"}])",
+              frame);
+}
+
+void dropsBytesOfSupersededMessages(testcpplite::TestResult &result) {
+  MessageBatch pending;
+  MessageBatch batch;
+  JsonView view{batch};
+  view.markAsSaved();
+  const auto size{batch.size()};
+  for (auto i{0}; i < 100; ++i) {
+    pending.append(batch);
+    assertEqual(result, size, pending.size());
+  }
+  assertEqual(result, std::size_t{1}, pending.messages().size());
+}
+
+void formatsAmountsLikeStreams(testcpplite::TestResult &result) {
+  assertEqual(
+      result,
+      R"([{"method":"update account allocation","accountIndex":1,)"
+      R"("amount":"-0.15"},)"
+      R"({"method":"update account balance","accountIndex":1,)"
+      R"("amount":"1234.05"}])",
+      frame([](View &view) {
+        view.updateAccountAllocation(1, USD{-15});
+        view.updateAccountBalance(1, 123405_cents);
+      }));
+}
+
+static auto messagePackFrame(const std::function<void(View &)> &f)
+    -> std::string {
+  MessageBatch batch;
+  MessagePackView view{batch};
+  f(view);
+  std::string frame;
+  writeMessagePackFrame(frame, batch);
+  return frame;
+}
+
+void packsTransactionRow(testcpplite::TestResult &result) {
+  assertEqual(result,
+              std::string{"\x91\x97\x06\x01\x17\xa5hyvee\xcd\x11\xb6"
+                          "\xce\x01\x34\x14\xc3\x07",
+                          20},
+              messagePackFrame([](View &view) {
+                view.addTransactionRow(1, 4534_cents,
+                                       Date{2019, Month::April, 3}, "hyvee",
+                                       23, 7);
+              }));
+}
+
+void packsNegativeAmounts(testcpplite::TestResult &result) {
+  assertEqual(result,
+              std::string{"\x92\x93\x04\x01\xff\x92\x00\xd1\xfc\x18", 10},
+              messagePackFrame([](View &view) {
+                view.updateAccountAllocation(1, USD{-1});
+                view.updateNetIncome(USD{-1});
+                view.updateNetIncome(USD{-1000});
+              }));
+}
+
+void packsLongStrings(testcpplite::TestResult &result) {
+  const std::string name(40, 'a');
+  assertEqual(result, "\x91\x93\x03\x02\xd9\x28" + name,
+              messagePackFrame(
+                  [&name](View &view) { view.setAccountName(2, name); }));
+}
+
+void writesFrameHeader(testcpplite::TestResult &result) {
+  MessageBatch batch;
+  JsonView view{batch};
+  view.markAsSaved();
+  std::string frame;
+  writeJsonFrame(frame, {1234567890123, true}, batch);
+  assertEqual(result,
+              R"({"sequence":1234567890123,"snapshot":true,)"
+              R"("messages":[{"method":"mark as saved"}]})",
+              frame);
+}
+
+void packsFrameHeader(testcpplite::TestResult &result) {
+  MessageBatch batch;
+  MessagePackView view{batch};
+  view.markAsSaved();
+  std::string frame;
+  writeMessagePackFrame(frame, {300, false}, batch);
+  assertEqual(result, std::string{"\x93\xcd\x01\x2c\xc2\x91\x91\x0a", 8},
+              frame);
+}
+
+void parsesTransactionCommand(testcpplite::TestResult &result) {
+  const auto command{jsonCommand(
+      R"({ "method": "add transaction", "name": "Gas",)"
+      R"( "description": "quicktrip", "amount": "41.02", "date": "10/23/14" })")};
+  assertTrue(result, command.method == Command::Method::addTransaction);
+  assertEqual(result, "Gas", command.accountName);
+  assertEqual(
+      result,
+      Transaction{4102_cents, "quicktrip", Date{14, Month::October, 23}},
+      command.transaction);
+}
+
+void parsesDateFromDateInput(testcpplite::TestResult &result) {
+  assertEqual(result, Date{2021, Month::November, 20},
+              jsonCommand(R"({"date":"2021-11-20"})").transaction.date);
+}
+
+void unescapesStrings(testcpplite::TestResult &result) {
+  assertEqual(
+      result, "\"a\\b\"\n\xc3\xa9\xf0\x9f\x98\x80/",
+      jsonCommand(R"({"description":"\"a\\b\"\n\u00e9\ud83d\ude00\/"})")
+          .transaction.description);
+}
+
+void ignoresUnknownFields(testcpplite::TestResult &result) {
+  const auto command{jsonCommand(R"({"seq":[1,{"a":"}"}],"ok":true,)"
+                                 R"("method":"remove account","name":"x"})")};
+  assertTrue(result, command.method == Command::Method::removeAccount);
+  assertEqual(result, "x", command.accountName);
+}
+
+void decodesMalformedCommandAsUnknown(testcpplite::TestResult &result) {
+  assertTrue(result,
+             jsonCommand(R"({"method":"reduce")").method ==
+                 Command::Method::unknown);
+  assertTrue(result, jsonCommand(R"({"method":"reduces"})").method ==
+                         Command::Method::unknown);
+  assertTrue(result,
+             jsonCommand(R"({"method":"\ud800"})").method ==
+                 Command::Method::unknown);
+}
+
+void recognizesEachMethod(testcpplite::TestResult &result) {
+  for (const auto &[name, method] :
+       {std::pair{"save", Command::Method::save},
+        std::pair{"reduce", Command::Method::reduce},
+        std::pair{"restore", Command::Method::restore},
+        std::pair{"transfer", Command::Method::transfer},
+        std::pair{"allocate", Command::Method::allocate},
+        std::pair{"add transaction", Command::Method::addTransaction},
+        std::pair{"remove transaction", Command::Method::removeTransaction},
+        std::pair{"verify transaction", Command::Method::verifyTransaction},
+        std::pair{"update transaction", Command::Method::updateTransaction},
+        std::pair{"move transaction", Command::Method::moveTransaction},
+        std::pair{"create account", Command::Method::createAccount},
+        std::pair{"rename account", Command::Method::renameAccount},
+        std::pair{"remove account", Command::Method::removeAccount},
+        std::pair{"close account", Command::Method::closeAccount}})
+    assertTrue(result, jsonCommand(std::string{R"({"method":")"} + name +
+                                   R"("})")
+                               .method == method);
+}
+
+void namesEachMethod(testcpplite::TestResult &result) {
+  for (const auto &[name, method] :
+       {std::pair{"save", Command::Method::save},
+        std::pair{"reduce", Command::Method::reduce},
+        std::pair{"restore", Command::Method::restore},
+        std::pair{"transfer", Command::Method::transfer},
+        std::pair{"allocate", Command::Method::allocate},
+        std::pair{"add transaction", Command::Method::addTransaction},
+        std::pair{"remove transaction", Command::Method::removeTransaction},
+        std::pair{"verify transaction", Command::Method::verifyTransaction},
+        std::pair{"update transaction", Command::Method::updateTransaction},
+        std::pair{"move transaction", Command::Method::moveTransaction},
+        std::pair{"create account", Command::Method::createAccount},
+        std::pair{"rename account", Command::Method::renameAccount},
+        std::pair{"remove account", Command::Method::removeAccount},
+        std::pair{"close account", Command::Method::closeAccount}})
+    assertEqual(result, name, methodName(method));
+  assertEqual(result, "unknown", methodName(Command::Method::unknown));
+}
+
+void appliesIncomeTransaction(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget,
+        jsonCommand(R"({"method":"verify transaction","name":"Income",)"
+                    R"("description":"pay","amount":"1","date":"1/2/2023"})"));
+  assertEqual(result, "verifyIncome", budget.method);
+  assertEqual(result,
+              Transaction{100_cents, "pay", Date{2023, Month::January, 2}},
+              budget.transaction);
+}
+
+void appliesTransactionById(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget, jsonCommand(R"({"method":"verify transaction","name":"Food",)"
+                            R"("id":12})"));
+  assertEqual(result, "verifyExpense", budget.method);
+  assertEqual(result, "Food", budget.accountName);
+  assertEqual(result, TransactionId{12}, budget.transactionId);
+}
+
+void appliesIncomeTransactionById(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget, jsonCommand(R"({"method":"remove transaction",)"
+                            R"("name":"Income","id":3})"));
+  assertEqual(result, "removeIncome", budget.method);
+  assertEqual(result, TransactionId{3}, budget.transactionId);
+}
+
+void appliesTransactionUpdate(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget,
+        jsonCommand(R"({"method":"update transaction","name":"Food","id":5,)"
+                    R"("description":"pizza","amount":"9.5",)"
+                    R"("date":"1/2/2023"})"));
+  assertEqual(result, "updateExpense", budget.method);
+  assertEqual(result, "Food", budget.accountName);
+  assertEqual(result, TransactionId{5}, budget.transactionId);
+  assertEqual(result,
+              Transaction{950_cents, "pizza", Date{2023, Month::January, 2}},
+              budget.transaction);
+}
+
+void appliesTransactionMove(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget, jsonCommand(R"({"method":"move transaction","name":"Food",)"
+                            R"("newName":"Dining","id":5})"));
+  assertEqual(result, "moveExpense", budget.method);
+  assertEqual(result, "Food", budget.accountName);
+  assertEqual(result, "Dining", budget.newAccountName);
+  assertEqual(result, TransactionId{5}, budget.transactionId);
+}
+
+void appliesExpenseTransaction(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget,
+        jsonCommand(R"({"method":"remove transaction","name":"Food",)"
+                    R"("description":"pizza","amount":"9.5",)"
+                    R"("date":"1/2/2023"})"));
+  assertEqual(result, "removeExpense", budget.method);
+  assertEqual(result, "Food", budget.accountName);
+  assertEqual(result,
+              Transaction{950_cents, "pizza", Date{2023, Month::January, 2}},
+              budget.transaction);
+}
+
+void appliesRename(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget, jsonCommand(R"({"method":"rename account","name":"Food",)"
+                            R"("newName":"Groceries"})"));
+  assertEqual(result, "renameAccount", budget.method);
+  assertEqual(result, "Food", budget.accountName);
+  assertEqual(result, "Groceries", budget.newAccountName);
+}
+
+void appliesTransfer(testcpplite::TestResult &result) {
+  BudgetStub budget;
+  apply(budget,
+        jsonCommand(R"({"method":"transfer","name":"Health","amount":"12.3"})"));
+  assertEqual(result, "transferTo", budget.method);
+  assertEqual(result, "Health", budget.accountName);
+  assertEqual(result, 1230_cents, budget.amount);
+}
+} // namespace sbash64::budget::protocol
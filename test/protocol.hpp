@@ -0,0 +1,43 @@
+#ifndef SBASH64_BUDGET_TEST_PROTOCOL_HPP_
+#define SBASH64_BUDGET_TEST_PROTOCOL_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::protocol {
+void writesTransactionRow(testcpplite::TestResult &);
+void writesTransactionRowUpdate(testcpplite::TestResult &);
+void writesTransactionRowMove(testcpplite::TestResult &);
+void writesMessageWithoutFields(testcpplite::TestResult &);
+void escapesDescription(testcpplite::TestResult &);
+void replacesInvalidUtf8(testcpplite::TestResult &);
+void writesEachMessageOfFrame(testcpplite::TestResult &);
+void keepsLatestBalanceOfEachAccount(testcpplite::TestResult &);
+void keepsLatestSavedState(testcpplite::TestResult &);
+void keepsBalancesAcrossAccountIndexChange(testcpplite::TestResult &);
+void reusesBufferAfterClear(testcpplite::TestResult &);
+void coalescesAppendedBatches(testcpplite::TestResult &);
+void dropsBytesOfSupersededMessages(testcpplite::TestResult &);
+void formatsAmountsLikeStreams(testcpplite::TestResult &);
+void packsTransactionRow(testcpplite::TestResult &);
+void packsNegativeAmounts(testcpplite::TestResult &);
+void packsLongStrings(testcpplite::TestResult &);
+void writesFrameHeader(testcpplite::TestResult &);
+void packsFrameHeader(testcpplite::TestResult &);
+void parsesTransactionCommand(testcpplite::TestResult &);
+void parsesDateFromDateInput(testcpplite::TestResult &);
+void unescapesStrings(testcpplite::TestResult &);
+void ignoresUnknownFields(testcpplite::TestResult &);
+void decodesMalformedCommandAsUnknown(testcpplite::TestResult &);
+void recognizesEachMethod(testcpplite::TestResult &);
+void namesEachMethod(testcpplite::TestResult &);
+void appliesIncomeTransaction(testcpplite::TestResult &);
+void appliesExpenseTransaction(testcpplite::TestResult &);
+void appliesRename(testcpplite::TestResult &);
+void appliesTransfer(testcpplite::TestResult &);
+void appliesTransactionById(testcpplite::TestResult &);
+void appliesIncomeTransactionById(testcpplite::TestResult &);
+void appliesTransactionUpdate(testcpplite::TestResult &);
+void appliesTransactionMove(testcpplite::TestResult &);
+} // namespace sbash64::budget::protocol
+
+#endif
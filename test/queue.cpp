@@ -0,0 +1,59 @@
+#include "queue.hpp"
+
+#include <sbash64/budget/queue.hpp>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sbash64::budget::queue {
+template <typename T> static auto pop(MpscQueue<T> &queue) -> T {
+  for (;;) {
+    if (auto value{queue.tryPop()})
+      return std::move(*value);
+    std::this_thread::yield();
+  }
+}
+
+void popsInPushOrder(testcpplite::TestResult &result) {
+  MpscQueue<std::string> queue;
+  queue.push("a");
+  queue.push("b");
+  assertEqual(result, "a", pop(queue));
+  assertEqual(result, "b", pop(queue));
+}
+
+void popsNothingWhenEmpty(testcpplite::TestResult &result) {
+  MpscQueue<int> queue;
+  assertFalse(result, queue.tryPop().has_value());
+  queue.push(1);
+  pop(queue);
+  assertFalse(result, queue.tryPop().has_value());
+}
+
+void popsEveryValueOfConcurrentProducers(testcpplite::TestResult &result) {
+  constexpr auto producers{4};
+  constexpr auto valuesPerProducer{10000};
+  MpscQueue<int> queue;
+  std::vector<std::thread> threads;
+  threads.reserve(producers);
+  for (auto producer{0}; producer < producers; ++producer)
+    threads.emplace_back([&queue, producer] {
+      for (auto i{0}; i < valuesPerProducer; ++i)
+        queue.push(producer * valuesPerProducer + i);
+    });
+  std::vector<int> next(producers);
+  auto ordered{true};
+  for (auto i{0}; i < producers * valuesPerProducer; ++i) {
+    const auto value{pop(queue)};
+    auto &expected{next.at(value / valuesPerProducer)};
+    ordered = ordered && value % valuesPerProducer == expected;
+    ++expected;
+  }
+  for (auto &thread : threads)
+    thread.join();
+  assertTrue(result, ordered);
+  assertFalse(result, queue.tryPop().has_value());
+}
+} // namespace sbash64::budget::queue
@@ -0,0 +1,12 @@
+#ifndef SBASH64_BUDGET_TEST_QUEUE_HPP_
+#define SBASH64_BUDGET_TEST_QUEUE_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::queue {
+void popsInPushOrder(testcpplite::TestResult &);
+void popsNothingWhenEmpty(testcpplite::TestResult &);
+void popsEveryValueOfConcurrentProducers(testcpplite::TestResult &);
+} // namespace sbash64::budget::queue
+
+#endif
@@ -0,0 +1,52 @@
+#include "ranked.hpp"
+
+#include <sbash64/budget/ranked.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace sbash64::budget::ranked {
+static auto rank(const RankedSet<int> &set, int value) -> std::size_t {
+  return set.rank(value).value_or(set.size());
+}
+
+void ranksInOrder(testcpplite::TestResult &result) {
+  RankedSet<int> set;
+  assertEqual(result, std::size_t{0}, set.insert(std::make_unique<int>(5)));
+  assertEqual(result, std::size_t{0}, set.insert(std::make_unique<int>(2)));
+  assertEqual(result, std::size_t{2}, set.insert(std::make_unique<int>(9)));
+  assertEqual(result, std::size_t{2}, set.insert(std::make_unique<int>(7)));
+  assertEqual(result, std::size_t{0}, rank(set, 2));
+  assertEqual(result, std::size_t{1}, rank(set, 5));
+  assertEqual(result, std::size_t{2}, rank(set, 7));
+  assertEqual(result, std::size_t{3}, rank(set, 9));
+}
+
+void visitsInOrder(testcpplite::TestResult &result) {
+  RankedSet<int> set;
+  for (auto value : {4, 8, 1, 6, 3})
+    set.insert(std::make_unique<int>(value));
+  std::vector<int> visited;
+  set.forEach([&visited](int value) { visited.push_back(value); });
+  assertTrue(result, std::vector<int>{1, 3, 4, 6, 8} == visited);
+}
+
+void ranksNothingExtracted(testcpplite::TestResult &result) {
+  RankedSet<int> set;
+  for (auto value{0}; value < 1000; ++value)
+    set.insert(std::make_unique<int>(value));
+  for (auto value{0}; value < 1000; value += 2)
+    assertEqual(result, value, *set.extract(value));
+  assertEqual(result, std::size_t{500}, set.size());
+  assertFalse(result, set.rank(500).has_value());
+  assertEqual(result, std::size_t{250}, rank(set, 501));
+}
+
+void extractsNothingAbsent(testcpplite::TestResult &result) {
+  RankedSet<int> set;
+  set.insert(std::make_unique<int>(1));
+  assertTrue(result, set.extract(2) == nullptr);
+  assertEqual(result, std::size_t{1}, set.size());
+}
+} // namespace sbash64::budget::ranked
@@ -0,0 +1,13 @@
+#ifndef SBASH64_BUDGET_TEST_RANKED_HPP_
+#define SBASH64_BUDGET_TEST_RANKED_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::ranked {
+void ranksInOrder(testcpplite::TestResult &);
+void visitsInOrder(testcpplite::TestResult &);
+void ranksNothingExtracted(testcpplite::TestResult &);
+void extractsNothingAbsent(testcpplite::TestResult &);
+} // namespace sbash64::budget::ranked
+
+#endif
@@ -0,0 +1,70 @@
+#include "recording.hpp"
+
+#include <sbash64/budget/recording.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+namespace sbash64::budget::recording {
+using namespace std::chrono_literals;
+
+static auto recorded(std::string_view budget) -> std::string {
+  std::ostringstream stream;
+  RecordingWriter writer{stream, budget};
+  writer.write(5us, R"({"method":"save"})");
+  writer.write(300s, std::string(200, 'x'));
+  return stream.str();
+}
+
+void readsWhatWasWritten(testcpplite::TestResult &result) {
+  std::istringstream stream{recorded("Income\n12.34 walmart 3/2/2021\n")};
+  RecordingReader reader{stream};
+  assertTrue(result, reader.valid());
+  assertEqual(result, "Income\n12.34 walmart 3/2/2021\n", reader.budget());
+  const auto first{reader.next()};
+  assertTrue(result, first.has_value());
+  assertTrue(result, first->sinceStart == 5us);
+  assertEqual(result, R"({"method":"save"})", first->payload);
+  const auto second{reader.next()};
+  assertTrue(result, second.has_value());
+  assertTrue(result, second->sinceStart == 300s);
+  assertEqual(result, std::string(200, 'x'), second->payload);
+  assertFalse(result, reader.next().has_value());
+}
+
+void keepsTimesFromGoingBackward(testcpplite::TestResult &result) {
+  std::stringstream stream;
+  RecordingWriter writer{stream, ""};
+  writer.write(10us, "a");
+  writer.write(7us, "b");
+  RecordingReader reader{stream};
+  assertTrue(result, reader.next()->sinceStart == 10us);
+  assertTrue(result, reader.next()->sinceStart == 10us);
+}
+
+void stopsAtPayloadCutShort(testcpplite::TestResult &result) {
+  auto data{recorded("")};
+  data.pop_back();
+  std::istringstream stream{data};
+  RecordingReader reader{stream};
+  assertTrue(result, reader.next().has_value());
+  assertFalse(result, reader.next().has_value());
+}
+
+void rejectsOtherStreams(testcpplite::TestResult &result) {
+  std::istringstream stream{"Income\n12.34 walmart 3/2/2021\n"};
+  RecordingReader reader{stream};
+  assertFalse(result, reader.valid());
+  assertFalse(result, reader.next().has_value());
+}
+
+void writesSmallPayloadsCompactly(testcpplite::TestResult &result) {
+  std::ostringstream empty;
+  RecordingWriter{empty, ""};
+  std::ostringstream stream;
+  RecordingWriter writer{stream, ""};
+  writer.write(200us, "abc");
+  assertEqual(result, empty.str().size() + 2 + 1 + 3, stream.str().size());
+}
+} // namespace sbash64::budget::recording
@@ -0,0 +1,14 @@
+#ifndef SBASH64_BUDGET_TEST_RECORDING_HPP_
+#define SBASH64_BUDGET_TEST_RECORDING_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::recording {
+void readsWhatWasWritten(testcpplite::TestResult &);
+void keepsTimesFromGoingBackward(testcpplite::TestResult &);
+void stopsAtPayloadCutShort(testcpplite::TestResult &);
+void rejectsOtherStreams(testcpplite::TestResult &);
+void writesSmallPayloadsCompactly(testcpplite::TestResult &);
+} // namespace sbash64::budget::recording
+
+#endif
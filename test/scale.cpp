@@ -0,0 +1,313 @@
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/counting-view.hpp>
+#include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/serialization.hpp>
+#include <sbash64/budget/string-streams.hpp>
+#include <sbash64/budget/transaction.hpp>
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Slow tests that grow a budget fourfold at a time and check that, at each
+// step, the time an operation takes grows no faster than its complexity
+// allows. The smallest budget is already too big for a core's own caches,
+// so the time may grow by three times beyond the ideal as memory gets
+// further away; the next complexity class up grows at least three and a half
+// times more per step. Measurements are written to stdout. Built only with
+// SBASH64_BUDGET_ENABLE_SCALE_TESTS.
+namespace sbash64::budget::scale {
+namespace {
+constexpr std::array<int, 3> sizes{20000, 80000, 320000};
+constexpr std::array<std::string_view, 12> accountNames{
+    "Clothing", "Dining",  "Entertainment", "Gas",   "Gifts",  "Groceries",
+    "Insurance", "Medical", "Phone",         "Rent",  "Travel", "Utilities"};
+constexpr auto trials{5};
+constexpr auto callsPerTrial{200};
+constexpr auto memoryHierarchySlack{3.};
+
+enum class Complexity { constant, logarithmic, linear, linearithmic };
+
+auto ideal(Complexity complexity, double n) -> double {
+  if (complexity == Complexity::constant)
+    return 1;
+  if (complexity == Complexity::logarithmic)
+    return std::log2(n);
+  if (complexity == Complexity::linear)
+    return n;
+  return n * std::log2(n);
+}
+
+// The growth allowed from one size to the next.
+auto allowedGrowth(Complexity complexity, int from, int to) -> double {
+  return ideal(complexity, to) / ideal(complexity, from) *
+         memoryHierarchySlack;
+}
+
+auto accountName(TransactionId id) -> std::string_view {
+  return accountNames.at((id - 1) % accountNames.size());
+}
+
+// The expense with ID n goes to account (n - 1) % 12, on a date that
+// interleaves it with the others there.
+auto expense(int index) -> Transaction {
+  return {USD{index % 10000}, "walmart",
+          Date{2020 + index % 3, Month{index % 12 + 1}, index % 28 + 1}};
+}
+
+void addExpenses(Budget &budget, int count) {
+  for (auto i{0}; i < count; ++i)
+    budget.addExpense(accountName(static_cast<TransactionId>(i) + 1),
+                      expense(i));
+}
+
+// A budget of expenses alone, whose IDs are 1 through size in order.
+struct Fixture {
+  Fixture(int size, bool presented) {
+    budget.attach(presenter);
+    if (presented)
+      presenter.attach(&view);
+    addExpenses(budget, size);
+  }
+
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount{transactionFactory};
+  AccountInMemory::Factory accountFactory{transactionFactory};
+  BudgetInMemory budget{incomeAccount, accountFactory};
+  BudgetPresenter presenter{incomeAccount};
+  CountingView view;
+  WritesTransactionToStream::Factory transactionSerializationFactory;
+  WritesAccountToStream::Factory accountSerializationFactory{
+      transactionSerializationFactory};
+  ReadsTransactionFromStream::Factory transactionDeserializationFactory;
+  ReadsAccountFromStream::Factory accountDeserializationFactory{
+      transactionDeserializationFactory};
+  StringStreamFactory streams;
+};
+
+// The least time over several trials of the operation, per call.
+auto fastest(const std::function<void(int trial)> &setUp,
+             const std::function<void(int trial)> &operation, int calls)
+    -> double {
+  auto best{std::numeric_limits<double>::max()};
+  for (auto trial{0}; trial < trials; ++trial) {
+    setUp(trial);
+    const auto start{std::chrono::steady_clock::now()};
+    operation(trial);
+    best = std::min(
+        best, std::chrono::duration<double, std::nano>{
+                  std::chrono::steady_clock::now() - start}
+                      .count() /
+                  calls);
+  }
+  return best;
+}
+
+// Measures at each size and fails when the time grows by more than the
+// complexity allows from one size to the next. Stops there, since the next
+// size could then take far longer.
+void assertGrowth(testcpplite::TestResult &result, std::string_view name,
+                  Complexity complexity,
+                  const std::function<double(int size)> &measure) {
+  std::cout << "scale " << name << ':' << std::flush;
+  auto withinBounds{true};
+  auto previous{0.};
+  for (std::size_t i{0}; i < sizes.size() && withinBounds; ++i) {
+    const auto nanoseconds{measure(sizes.at(i))};
+    std::cout << ' ' << sizes.at(i) << " -> " << nanoseconds << " ns"
+              << std::flush;
+    withinBounds = i == 0 || nanoseconds <= previous * allowedGrowth(
+                                                           complexity,
+                                                           sizes.at(i - 1),
+                                                           sizes.at(i));
+    previous = nanoseconds;
+  }
+  std::cout << '\n';
+  assertTrue(result, withinBounds);
+}
+
+// The IDs one trial visits, spread over the budget and apart from those of
+// other trials.
+auto trialId(int size, int trial, int call) -> TransactionId {
+  const auto stride{size / (trials * callsPerTrial)};
+  return TransactionId{static_cast<std::uint_least64_t>(
+      1 + (trial * callsPerTrial + call) * stride)};
+}
+} // namespace
+
+// Its presenter ranks the row.
+void addsExpenseInLogarithmicTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "add", Complexity::logarithmic, [](int size) {
+    Fixture fixture{size, false};
+    return fastest(
+        [](int) {},
+        [&](int trial) {
+          for (auto i{0}; i < callsPerTrial; ++i)
+            fixture.budget.addExpense(
+                accountName(static_cast<TransactionId>(i) + 1),
+                expense(trial + i));
+        },
+        callsPerTrial);
+  });
+}
+
+// Every trial verifies the same expenses, so the fastest finds them in cache
+// whatever the size of the budget, and what is left is the lookup.
+void verifiesExpenseInConstantTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "verify", Complexity::constant, [](int size) {
+    Fixture fixture{size, false};
+    return fastest(
+        [](int) {},
+        [&](int) {
+          for (auto i{0}; i < callsPerTrial; ++i) {
+            const auto id{trialId(size, 0, i)};
+            fixture.budget.verifyExpense(accountName(id), id);
+          }
+        },
+        callsPerTrial);
+  });
+}
+
+// The account finds the expense by ID, and its presenter finds the row in a
+// tree.
+void removesExpenseInLogarithmicTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "remove", Complexity::logarithmic, [](int size) {
+    Fixture fixture{size, false};
+    return fastest(
+        [](int) {},
+        [&](int trial) {
+          for (auto i{0}; i < callsPerTrial; ++i) {
+            const auto id{trialId(size, trial, i)};
+            fixture.budget.removeExpense(accountName(id), id);
+          }
+        },
+        callsPerTrial);
+  });
+}
+
+// The presenter finds the row by ID and ranks it in both accounts. Trials
+// move the same expenses there and back, so that, as with verify, the fastest
+// finds them in cache.
+void movesExpenseInLogarithmicTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "move", Complexity::logarithmic, [](int size) {
+    Fixture fixture{size, false};
+    return fastest(
+        [](int) {},
+        [&](int trial) {
+          for (auto i{0}; i < callsPerTrial; ++i) {
+            const auto id{trialId(size, 0, i)};
+            const auto there{trial % 2 == 0};
+            fixture.budget.moveExpense(accountName(there ? id : id + 1),
+                                       accountName(there ? id + 1 : id), id);
+          }
+        },
+        callsPerTrial);
+  });
+}
+
+void reducesInLinearTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "reduce", Complexity::linear, [](int size) {
+    std::unique_ptr<Fixture> fixture;
+    return fastest(
+        [&](int) {
+          fixture = std::make_unique<Fixture>(size, false);
+          for (auto id{TransactionId{1}}; id <= TransactionId(size); id += 2)
+            fixture->budget.verifyExpense(accountName(id), id);
+        },
+        [&](int) { fixture->budget.reduce(); }, 1);
+  });
+}
+
+void savesInLinearTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "save", Complexity::linear, [](int size) {
+    Fixture fixture{size, false};
+    WritesBudgetToStream serialization{fixture.streams,
+                                       fixture.accountSerializationFactory};
+    return fastest(
+        [](int) {}, [&](int) { fixture.budget.save(serialization); }, 1);
+  });
+}
+
+// Each loaded row is ranked as it is added.
+void loadsInLinearithmicTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "load", Complexity::linearithmic, [](int size) {
+    Fixture fixture{size, false};
+    WritesBudgetToStream serialization{fixture.streams,
+                                       fixture.accountSerializationFactory};
+    fixture.budget.save(serialization);
+    ReadsBudgetFromStream deserialization{
+        fixture.streams, fixture.accountDeserializationFactory};
+    return fastest(
+        [](int) {}, [&](int) { fixture.budget.load(deserialization); }, 1);
+  });
+}
+
+// A presented row is numbered by its rank, which the tree counts as it
+// descends.
+void presentsAddedExpenseInLogarithmicTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "presented add", Complexity::logarithmic, [](int size) {
+    Fixture fixture{size, true};
+    return fastest(
+        [](int) {},
+        [&](int trial) {
+          for (auto i{0}; i < callsPerTrial; ++i)
+            fixture.budget.addExpense(
+                accountName(static_cast<TransactionId>(i) + 1),
+                expense(trial + i));
+        },
+        callsPerTrial);
+  });
+}
+
+// Adding every expense to a presented budget, which would be quadratic if
+// numbering one row took linear time.
+void presentsBudgetInLinearithmicTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "presented build", Complexity::linearithmic,
+               [](int size) {
+                 std::unique_ptr<Fixture> fixture;
+                 return fastest(
+                     [&](int) {
+                       fixture = std::make_unique<Fixture>(0, true);
+                     },
+                     [&](int) { addExpenses(fixture->budget, size); }, 1);
+               });
+}
+
+void catchesUpInLinearTime(testcpplite::TestResult &result) {
+  assertGrowth(result, "catch up", Complexity::linear, [](int size) {
+    Fixture fixture{size, false};
+    CountingView view;
+    return fastest(
+        [](int) {}, [&](int) { fixture.presenter.catchUp(&view); }, 1);
+  });
+}
+} // namespace sbash64::budget::scale
+
+auto main() -> int {
+  using namespace sbash64::budget::scale;
+  return sbash64::testcpplite::test(
+      {{addsExpenseInLogarithmicTime, "scale::addsExpenseInLogarithmicTime"},
+       {verifiesExpenseInConstantTime,
+        "scale::verifiesExpenseInConstantTime"},
+       {removesExpenseInLogarithmicTime,
+        "scale::removesExpenseInLogarithmicTime"},
+       {movesExpenseInLogarithmicTime, "scale::movesExpenseInLogarithmicTime"},
+       {reducesInLinearTime, "scale::reducesInLinearTime"},
+       {savesInLinearTime, "scale::savesInLinearTime"},
+       {loadsInLinearithmicTime, "scale::loadsInLinearithmicTime"},
+       {presentsAddedExpenseInLogarithmicTime,
+        "scale::presentsAddedExpenseInLogarithmicTime"},
+       {presentsBudgetInLinearithmicTime,
+        "scale::presentsBudgetInLinearithmicTime"},
+       {catchesUpInLinearTime, "scale::catchesUpInLinearTime"}},
+      std::cout);
+}
@@ -0,0 +1,92 @@
+#include "trace.hpp"
+
+#include <sbash64/budget/trace.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace sbash64::budget::trace {
+using namespace std::chrono_literals;
+
+void nestsSpansByThread(testcpplite::TestResult &result) {
+  std::ostringstream log;
+  Tracer tracer{8, 1h, log};
+  {
+    TraceSpan outer{tracer, "drain"};
+    TraceSpan inner{tracer, "apply", "save"};
+  }
+  const auto events{tracer.events()};
+  assertEqual(result, std::size_t{2}, events.size());
+  assertEqual(result, "apply", std::string{events.at(0).name});
+  assertEqual(result, "save", events.at(0).detail);
+  assertEqual(result, 1, events.at(0).depth);
+  assertEqual(result, "drain", std::string{events.at(1).name});
+  assertEqual(result, 0, events.at(1).depth);
+  assertTrue(result, events.at(1).begin <= events.at(0).begin);
+  assertTrue(result, events.at(0).duration <= events.at(1).duration);
+}
+
+void keepsLatestSpans(testcpplite::TestResult &result) {
+  std::ostringstream log;
+  Tracer tracer{2, 1h, log};
+  TraceSpan{tracer, "a"};
+  TraceSpan{tracer, "b"};
+  TraceSpan{tracer, "c"};
+  const auto events{tracer.events()};
+  assertEqual(result, std::size_t{2}, events.size());
+  assertEqual(result, "b", std::string{events.at(0).name});
+  assertEqual(result, "c", std::string{events.at(1).name});
+}
+
+void keepsLatestSpansOfEachThread(testcpplite::TestResult &result) {
+  std::ostringstream log;
+  Tracer tracer{1, 1h, log};
+  TraceSpan{tracer, "a"};
+  std::thread{[&tracer] {
+    TraceSpan{tracer, "b"};
+    TraceSpan{tracer, "c"};
+  }}.join();
+  const auto events{tracer.events()};
+  assertEqual(result, std::size_t{2}, events.size());
+  assertEqual(result, "a", std::string{events.at(0).name});
+  assertEqual(result, "c", std::string{events.at(1).name});
+  assertTrue(result, events.at(0).thread != events.at(1).thread);
+}
+
+void logsSlowSpanWithDescendants(testcpplite::TestResult &result) {
+  std::ostringstream log;
+  Tracer tracer{8, 0ns, log};
+  {
+    TraceSpan outer{tracer, "drain"};
+    { TraceSpan first{tracer, "apply", "add transaction"}; }
+    TraceSpan second{tracer, "flush"};
+    TraceSpan third{tracer, "encode"};
+  }
+  const auto logged{log.str()};
+  assertTrue(result, logged.starts_with("slow:\n  drain "));
+  assertTrue(result, logged.find("\n    apply add transaction ") !=
+                         std::string::npos);
+  assertTrue(result,
+             logged.find("\n    flush ") < logged.find("\n      encode "));
+}
+
+void logsNothingWhenFast(testcpplite::TestResult &result) {
+  std::ostringstream log;
+  Tracer tracer{8, 1h, log};
+  { TraceSpan span{tracer, "drain"}; }
+  assertEqual(result, "", log.str());
+}
+
+void writesChromeTrace(testcpplite::TestResult &result) {
+  std::string out;
+  writeChromeTrace(out, {{"drain", "", 1, 0, 1500ns, 2us},
+                         {"apply", "add \"x\"", 2, 1, 2us, 250ns}});
+  assertEqual(
+      result,
+      R"({"traceEvents":[{"name":"drain","ph":"X","pid":1,"tid":1,"ts":1.500,"dur":2.000},)"
+      R"({"name":"apply","ph":"X","pid":1,"tid":2,"ts":2.000,"dur":0.250,"args":{"detail":"add \"x\""}}],"displayTimeUnit":"ms"})",
+      out);
+}
+} // namespace sbash64::budget::trace
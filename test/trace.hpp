@@ -0,0 +1,15 @@
+#ifndef SBASH64_BUDGET_TEST_TRACE_HPP_
+#define SBASH64_BUDGET_TEST_TRACE_HPP_
+
+#include <sbash64/testcpplite/testcpplite.hpp>
+
+namespace sbash64::budget::trace {
+void nestsSpansByThread(testcpplite::TestResult &);
+void keepsLatestSpans(testcpplite::TestResult &);
+void keepsLatestSpansOfEachThread(testcpplite::TestResult &);
+void logsSlowSpanWithDescendants(testcpplite::TestResult &);
+void logsNothingWhenFast(testcpplite::TestResult &);
+void writesChromeTrace(testcpplite::TestResult &);
+} // namespace sbash64::budget::trace
+
+#endif
@@ -207,6 +207,43 @@ void removesInitializedTransaction(testcpplite::TestResult &result) {
   });
 }
 
+void verifiesOnce(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory record;
+  TransactionObserverStub observer;
+  record.attach(observer);
+  record.verify();
+  assertTrue(result, observer.verified());
+  assertTrue(result, record.verified());
+  TransactionObserverStub lateObserver;
+  record.attach(lateObserver);
+  record.verify();
+  assertFalse(result, lateObserver.verified());
+}
+
+void makesTransactionsWithDistinctIds(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory::Factory factory;
+  const auto first{factory.make()};
+  const auto second{factory.make()};
+  assertTrue(result, first->id() != second->id());
+}
+
+void updatesKeepingVerification(testcpplite::TestResult &result) {
+  ObservableTransactionInMemory record;
+  TransactionObserverStub observer;
+  record.attach(observer);
+  record.initialize(
+      Transaction{789_cents, "chimpanzee", Date{2020, Month::June, 1}});
+  record.verify();
+  record.update(Transaction{456_cents, "gorilla", Date{2020, Month::May, 2}});
+  assertEqual(result, {456_cents, "gorilla", Date{2020, Month::May, 2}},
+              observer.transaction());
+  TransactionSerializationStub serialization;
+  record.save(serialization);
+  assertEqual(result,
+              {{456_cents, "gorilla", Date{2020, Month::May, 2}}, true, false},
+              serialization.archivableVerifiableTransaction());
+}
+
 void doesNotRemoveUnequalTransaction(testcpplite::TestResult &result) {
   testObservableTransactionInMemory([&result](ObservableTransaction &record) {
     record.initialize(
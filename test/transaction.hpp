@@ -19,6 +19,9 @@ void notifiesObserverOfArchival(testcpplite::TestResult &);
 void doesNotNotifyObserverOfArchivalTwice(testcpplite::TestResult &);
 void removesInitializedTransaction(testcpplite::TestResult &);
 void doesNotRemoveUnequalTransaction(testcpplite::TestResult &);
+void verifiesOnce(testcpplite::TestResult &);
+void makesTransactionsWithDistinctIds(testcpplite::TestResult &);
+void updatesKeepingVerification(testcpplite::TestResult &);
 } // namespace sbash64::budget::transaction
 
 #endif
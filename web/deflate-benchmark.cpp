@@ -0,0 +1,154 @@
+#include <sbash64/budget/account.hpp>
+#include <sbash64/budget/budget.hpp>
+#include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/protocol.hpp>
+#include <sbash64/budget/transaction.hpp>
+
+#include <zlib.h>
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Measures what permessage-deflate costs and saves for the frames the server
+// sends: the snapshot a connecting client is caught up with, and a typical
+// update after one command.
+namespace sbash64::budget {
+namespace {
+constexpr std::array<std::string_view, 12> accountNames{
+    "Groceries", "Gas",       "Rent",    "Utilities",
+    "Dining",    "Insurance", "Medical", "Clothing",
+    "Gifts",     "Travel",    "Phone",   "Entertainment"};
+
+constexpr std::array<std::string_view, 16> descriptions{
+    "walmart",  "quicktrip",  "target", "chipotle", "amazon", "costco",
+    "shell",    "evergy",     "spire",  "verizon",  "cvs",    "kohls",
+    "southwest", "state farm", "netflix", "hy-vee"};
+
+// A couple of years of a household's spending.
+void populate(Budget &budget) {
+  for (const auto name : accountNames)
+    budget.createAccount(name);
+  std::uint_least32_t state{1};
+  const auto next{[&state] {
+    state = state * 1664525 + 1013904223;
+    return state >> 8;
+  }};
+  for (auto i{0}; i < 3000; ++i) {
+    const Date date{2019 + i / 1500, Month{static_cast<int>(next() % 12 + 1)},
+                    static_cast<int>(next() % 28 + 1)};
+    const USD amount{static_cast<std::int_least64_t>(next() % 20000 + 99)};
+    const auto description{descriptions.at(next() % descriptions.size())};
+    budget.addExpense(accountNames.at(next() % accountNames.size()),
+                      {amount, std::string{description}, date});
+    if (next() % 2 == 0)
+      budget.verifyExpense(accountNames.at(0),
+                           {amount, std::string{description}, date});
+  }
+  for (auto i{0}; i < 48; ++i)
+    budget.addIncome(
+        {USD{250000}, "paycheck", Date{2019 + i / 24, Month{i % 12 + 1}, 15}});
+}
+
+// Compresses each payload as a sequence of permessage-deflate messages on one
+// context, as a connection does, and returns the bytes on the wire.
+auto deflateMessages(const std::string &payload, int messages, int level,
+                     int windowBits, int memoryLevel) -> std::size_t {
+  z_stream stream{};
+  deflateInit2(&stream, level, Z_DEFLATED, -windowBits, memoryLevel,
+               Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&stream, payload.size()) + 16, '\0');
+  std::size_t total{0};
+  for (auto i{0}; i < messages; ++i) {
+    stream.next_in = reinterpret_cast<Bytef *>(
+        const_cast<char *>(payload.data()));
+    stream.avail_in = static_cast<uInt>(payload.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_SYNC_FLUSH);
+    // The trailing 00 00 ff ff of the flush is not sent.
+    total += out.size() - stream.avail_out - 4;
+  }
+  deflateEnd(&stream);
+  return total;
+}
+
+void report(std::string_view name, const std::string &payload,
+            int messages) {
+  std::cout << name << ": " << messages << " x " << payload.size()
+            << " bytes\n";
+  std::cout << "  level window memory      bytes    ratio   us/message\n";
+  for (const auto level : {1, Z_DEFAULT_COMPRESSION})
+    for (const auto windowBits : {9, 11, 13, 15})
+      for (const auto memoryLevel : {1, 4, 8}) {
+        constexpr auto repetitions{20};
+        std::size_t bytes{0};
+        const auto start{std::chrono::steady_clock::now()};
+        for (auto i{0}; i < repetitions; ++i)
+          bytes = deflateMessages(payload, messages, level, windowBits,
+                                  memoryLevel);
+        const std::chrono::duration<double, std::micro> elapsed{
+            std::chrono::steady_clock::now() - start};
+        std::cout << std::setw(7)
+                  << (level == Z_DEFAULT_COMPRESSION ? 6 : level)
+                  << std::setw(7) << windowBits << std::setw(7) << memoryLevel
+                  << std::setw(11) << bytes << std::setw(9)
+                  << std::fixed << std::setprecision(3)
+                  << static_cast<double>(bytes) /
+                         static_cast<double>(payload.size() * messages)
+                  << std::setw(13) << std::setprecision(1)
+                  << elapsed.count() / (repetitions * messages) << '\n';
+      }
+}
+
+auto makeView(MessageBatch &batch, bool json) -> std::unique_ptr<View> {
+  if (json)
+    return std::make_unique<JsonView>(batch);
+  return std::make_unique<MessagePackView>(batch);
+}
+
+auto frame(const MessageBatch &batch, bool json) -> std::string {
+  std::string payload;
+  if (json)
+    writeJsonFrame(payload, {1, false}, batch);
+  else
+    writeMessagePackFrame(payload, {1, false}, batch);
+  return payload;
+}
+
+void run() {
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount{transactionFactory};
+  AccountInMemory::Factory accountFactory{transactionFactory};
+  BudgetInMemory budget{incomeAccount, accountFactory};
+  BudgetPresenter presenter{incomeAccount};
+  budget.attach(presenter);
+  populate(budget);
+  for (const auto json : {true, false}) {
+    MessageBatch snapshot;
+    presenter.catchUp(makeView(snapshot, json).get());
+    report(json ? "JSON snapshot" : "MessagePack snapshot",
+           frame(snapshot, json), 1);
+
+    MessageBatch update;
+    const auto view{makeView(update, json)};
+    presenter.attach(view.get());
+    budget.addExpense("Gas",
+                      {USD{4102}, "quicktrip", Date{2021, Month::March, 2}});
+    presenter.remove(view.get());
+    report(json ? "JSON update" : "MessagePack update", frame(update, json),
+           100);
+  }
+}
+} // namespace
+} // namespace sbash64::budget
+
+int main() {
+  sbash64::budget::run();
+  return EXIT_SUCCESS;
+}
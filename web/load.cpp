@@ -0,0 +1,384 @@
+#define ASIO_STANDALONE
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Opens connections to sbash64-budget-web, sends them a weighted mix of
+// scripted commands at a fixed total rate and reports, as JSON, each
+// command's latency percentiles, the throughput and how long each connection
+// took to be caught up:
+//
+//   sbash64-budget-load ws://localhost:9012/household 50 200 30 load.json
+//
+// sends 200 commands a second over 50 connections for 30 seconds, where
+// load.json is a copy of loadClientMessages.json.
+//
+// The script is an array of messages like exampleClientMessages.json. An
+// optional "weight" says how often each is picked (1 by default); the server
+// ignores it. Every ${token} is replaced with a value unique to that send, so
+// that the frame carrying the command's effect can be recognized. A command
+// without one is timed to the next frame its connection receives, which may
+// be another connection's while they are busy. loadClientMessages.json uses
+// the accounts of a budget written by sbash64-budget-generate.
+namespace sbash64::budget {
+namespace {
+using Client = websocketpp::client<websocketpp::config::asio_client>;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto jsonSubprotocol{"sbash64-budget.json"};
+constexpr std::string_view tokenPlaceholder{"${token}"};
+// How long to wait for the effects of the last commands before closing.
+constexpr std::chrono::seconds drainTime{5};
+
+struct ScriptedCommand {
+  std::string message;
+  std::string method;
+  int weight{1};
+};
+
+// The objects of a JSON array, as written.
+auto objects(std::string_view array) -> std::vector<std::string_view> {
+  std::vector<std::string_view> found;
+  auto depth{0};
+  auto inString{false};
+  std::string_view::size_type begin{0};
+  for (std::string_view::size_type i{0}; i < array.size(); ++i) {
+    const auto c{array[i]};
+    if (inString) {
+      if (c == '\\')
+        ++i;
+      else if (c == '"')
+        inString = false;
+    } else if (c == '"') {
+      inString = true;
+    } else if (c == '{') {
+      if (depth++ == 0)
+        begin = i;
+    } else if (c == '}' && --depth == 0) {
+      found.push_back(array.substr(begin, i - begin + 1));
+    }
+  }
+  return found;
+}
+
+// The value of a top-level key, without its quotes. Good enough for scripts,
+// whose keys don't appear inside values.
+auto valueOf(std::string_view object, std::string_view key)
+    -> std::string_view {
+  const auto quoted{'"' + std::string{key} + '"'};
+  auto i{object.find(quoted)};
+  if (i == std::string_view::npos)
+    return {};
+  i = object.find_first_not_of(" \t\r\n:", i + quoted.size());
+  if (i == std::string_view::npos)
+    return {};
+  if (object[i] == '"')
+    return object.substr(i + 1, object.find('"', i + 1) - i - 1);
+  return object.substr(i, object.find_first_of(",} \t\r\n", i) - i);
+}
+
+auto script(std::string_view text) -> std::vector<ScriptedCommand> {
+  std::vector<ScriptedCommand> commands;
+  for (const auto object : objects(text)) {
+    ScriptedCommand command{std::string{object},
+                            std::string{valueOf(object, "method")}};
+    if (const auto weight{valueOf(object, "weight")}; !weight.empty())
+      command.weight = std::stoi(std::string{weight});
+    if (command.weight > 0)
+      commands.push_back(std::move(command));
+  }
+  return commands;
+}
+
+auto withToken(std::string message, std::string_view token) -> std::string {
+  for (auto found{message.find(tokenPlaceholder)};
+       found != std::string::npos;
+       found = message.find(tokenPlaceholder, found + token.size()))
+    message.replace(found, tokenPlaceholder.size(), token);
+  return message;
+}
+
+// Milliseconds at the usual percentiles.
+void writePercentiles(std::ostream &out, std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  const auto at{[&samples](double fraction) {
+    if (samples.empty())
+      return 0.;
+    return samples.at(static_cast<std::size_t>(
+        fraction * static_cast<double>(samples.size() - 1)));
+  }};
+  out << R"("p50":)" << at(.5) << R"(,"p90":)" << at(.9) << R"(,"p99":)"
+      << at(.99) << R"(,"max":)" << at(1);
+}
+
+auto milliseconds(Clock::duration duration) -> double {
+  return std::chrono::duration<double, std::milli>{duration}.count();
+}
+
+struct Options {
+  std::string uri;
+  int connections{};
+  double commandsPerSecond{};
+  std::chrono::seconds duration{};
+};
+
+class Load {
+public:
+  Load(Client &client, Options options, std::vector<ScriptedCommand> commands)
+      : client{client}, options{std::move(options)},
+        commands{std::move(commands)}, latencies(this->commands.size()),
+        sent(this->commands.size()), pick{weights(this->commands)},
+        connections(static_cast<std::size_t>(this->options.connections)) {}
+
+  void start() {
+    for (std::size_t i{0}; i < connections.size(); ++i)
+      connect(i);
+    started = Clock::now();
+    nextSend = started;
+    tick();
+  }
+
+  void report(std::ostream &out) const {
+    const auto elapsed{milliseconds(stopped - started) / 1000};
+    std::int_least64_t total{0};
+    for (const auto count : sent)
+      total += count;
+    std::vector<double> catchUps;
+    for (const auto &connection : connections)
+      if (connection.catchUp)
+        catchUps.push_back(milliseconds(*connection.catchUp));
+    out << R"({"connections":)" << connections.size() << R"(,"caughtUp":)"
+        << catchUps.size() << R"(,"seconds":)" << elapsed << R"(,"sent":)"
+        << total << R"(,"commandsPerSecond":)"
+        << static_cast<double>(total) / elapsed << R"(,"framesReceived":)"
+        << frames << R"(,"bytesReceived":)" << bytes
+        << R"(,"catchUpMilliseconds":{)";
+    writePercentiles(out, catchUps);
+    out << R"(,"each":[)";
+    for (std::size_t i{0}; i < connections.size(); ++i) {
+      if (i != 0)
+        out << ',';
+      if (const auto &catchUp{connections.at(i).catchUp})
+        out << milliseconds(*catchUp);
+      else
+        out << "null";
+    }
+    out << R"(]},"commands":[)";
+    for (std::size_t i{0}; i < commands.size(); ++i) {
+      if (i != 0)
+        out << ',';
+      out << "\n" << R"({"method":")" << commands.at(i).method
+          << R"(","sent":)" << sent.at(i) << R"(,"answered":)"
+          << latencies.at(i).size() << R"(,"latencyMilliseconds":{)";
+      writePercentiles(out, latencies.at(i));
+      out << "}}";
+    }
+    out << "]}\n";
+  }
+
+private:
+  struct Pending {
+    std::string token;
+    std::size_t command;
+    Clock::time_point sent;
+  };
+
+  struct Connection {
+    websocketpp::connection_hdl handle;
+    Clock::time_point connecting;
+    std::optional<Clock::duration> catchUp;
+    std::deque<Pending> pending;
+    bool open{};
+  };
+
+  static auto weights(const std::vector<ScriptedCommand> &commands)
+      -> std::discrete_distribution<std::size_t> {
+    std::vector<int> weights;
+    for (const auto &command : commands)
+      weights.push_back(command.weight);
+    return {weights.begin(), weights.end()};
+  }
+
+  void connect(std::size_t index) {
+    websocketpp::lib::error_code error;
+    const auto con{client.get_connection(options.uri, error)};
+    if (error) {
+      std::cerr << "could not connect: " << error.message() << '\n';
+      return;
+    }
+    con->add_subprotocol(jsonSubprotocol);
+    con->set_open_handler([this, index](const websocketpp::connection_hdl &) {
+      connections.at(index).open = true;
+    });
+    con->set_close_handler([this, index](const websocketpp::connection_hdl &) {
+      connections.at(index).open = false;
+    });
+    con->set_fail_handler([index](const websocketpp::connection_hdl &) {
+      std::cerr << "connection " << index << " failed\n";
+    });
+    con->set_message_handler(
+        [this, index](const websocketpp::connection_hdl &,
+                      const Client::message_ptr &message) {
+          receive(connections.at(index), message->get_payload());
+        });
+    auto &connection{connections.at(index)};
+    connection.handle = con->get_handle();
+    connection.connecting = Clock::now();
+    client.connect(con);
+  }
+
+  void receive(Connection &connection, std::string_view payload) {
+    const auto now{Clock::now()};
+    ++frames;
+    bytes += payload.size();
+    if (!connection.catchUp) {
+      connection.catchUp = now - connection.connecting;
+      return;
+    }
+    std::erase_if(connection.pending, [&](const Pending &pending) {
+      if (!pending.token.empty() &&
+          payload.find(pending.token) == std::string_view::npos)
+        return false;
+      latencies.at(pending.command).push_back(milliseconds(now - pending.sent));
+      return true;
+    });
+  }
+
+  // Sends whatever is due, round robin over the caught-up connections, so that
+  // the rate holds even when the timer fires late.
+  void tick() {
+    const auto now{Clock::now()};
+    if (now - started >= options.duration) {
+      stopped = now;
+      drain();
+      return;
+    }
+    const std::chrono::duration<double> period{1 / options.commandsPerSecond};
+    while (nextSend <= now) {
+      send();
+      nextSend += std::chrono::duration_cast<Clock::duration>(period);
+    }
+    after(nextSend - now, [this] { tick(); });
+  }
+
+  void send() {
+    for (std::size_t tried{0}; tried < connections.size(); ++tried) {
+      auto &connection{connections.at(nextConnection)};
+      nextConnection = (nextConnection + 1) % connections.size();
+      if (!connection.open || !connection.catchUp)
+        continue;
+      const auto command{pick(random)};
+      const auto &scripted{commands.at(command)};
+      std::string token;
+      if (scripted.message.find(tokenPlaceholder) != std::string::npos)
+        token = "load" + std::to_string(++tokens);
+      websocketpp::lib::error_code error;
+      client.send(connection.handle, withToken(scripted.message, token),
+                  websocketpp::frame::opcode::text, error);
+      if (error)
+        return;
+      connection.pending.push_back({std::move(token), command, Clock::now()});
+      ++sent.at(command);
+      return;
+    }
+  }
+
+  template <typename F> void after(Clock::duration delay, F f) {
+    client.set_timer(
+        std::chrono::ceil<std::chrono::milliseconds>(delay).count(),
+        [f](const websocketpp::lib::error_code &error) {
+          if (!error)
+            f();
+        });
+  }
+
+  // Waits for the effects of the last commands, then closes every
+  // connection, which lets the client's run return.
+  void drain() {
+    const auto waiting{std::any_of(
+        connections.begin(), connections.end(),
+        [](const Connection &c) { return c.open && !c.pending.empty(); })};
+    if (waiting && Clock::now() - stopped < drainTime) {
+      after(std::chrono::milliseconds{50}, [this] { drain(); });
+      return;
+    }
+    for (auto &connection : connections) {
+      websocketpp::lib::error_code ignoredBecauseClosing;
+      client.close(connection.handle, websocketpp::close::status::normal, "",
+                   ignoredBecauseClosing);
+    }
+  }
+
+  Client &client;
+  Options options;
+  std::vector<ScriptedCommand> commands;
+  std::vector<std::vector<double>> latencies;
+  std::vector<std::int_least64_t> sent;
+  std::discrete_distribution<std::size_t> pick;
+  std::mt19937 random{1};
+  std::vector<Connection> connections;
+  std::size_t nextConnection{};
+  std::int_least64_t tokens{};
+  std::int_least64_t frames{};
+  std::uintmax_t bytes{};
+  Clock::time_point started;
+  Clock::time_point nextSend;
+  Clock::time_point stopped;
+};
+
+void usage() {
+  std::cerr << "usage: sbash64-budget-load <uri> <connections> "
+               "<commands per second> <seconds> <script>\n";
+}
+
+auto run(int argc, char *argv[]) -> int {
+  if (argc < 6) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  const Options options{argv[1], std::stoi(argv[2]), std::stod(argv[3]),
+                        std::chrono::seconds{std::stoi(argv[4])}};
+  std::ifstream file{argv[5]};
+  std::stringstream text;
+  text << file.rdbuf();
+  auto commands{script(text.str())};
+  if (options.connections < 1 || options.commandsPerSecond <= 0 ||
+      commands.empty()) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  Client client;
+  client.clear_access_channels(websocketpp::log::alevel::all);
+  client.clear_error_channels(websocketpp::log::elevel::all);
+  client.init_asio();
+  Load load{client, options, std::move(commands)};
+  load.start();
+  try {
+    client.run();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  load.report(std::cout);
+  return EXIT_SUCCESS;
+}
+} // namespace
+} // namespace sbash64::budget
+
+int main(int argc, char *argv[]) { return sbash64::budget::run(argc, argv); }
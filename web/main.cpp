@@ -1,34 +1,109 @@
 #include <sbash64/budget/account.hpp>
 #include <sbash64/budget/budget.hpp>
-#include <sbash64/budget/parse.hpp>
+#include <sbash64/budget/memory.hpp>
+#include <sbash64/budget/metrics.hpp>
 #include <sbash64/budget/presentation.hpp>
+#include <sbash64/budget/protocol.hpp>
+#include <sbash64/budget/queue.hpp>
+#include <sbash64/budget/recording.hpp>
 #include <sbash64/budget/serialization.hpp>
+#include <sbash64/budget/trace.hpp>
 #include <sbash64/budget/transaction.hpp>
 
-#include <nlohmann/json.hpp>
-
 #define ASIO_STANDALONE
 #include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
 #include <websocketpp/logger/levels.hpp>
 #include <websocketpp/server.hpp>
 
+#include <zlib.h>
+
+#ifdef SBASH64_BUDGET_HAS_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 namespace sbash64::budget {
 namespace {
+// A setting from the environment, or fallback when it is not set or is not a
+// whole number.
+auto setting(const char *name, int fallback) -> int {
+  const auto *const value{std::getenv(name)};
+  if (value == nullptr)
+    return fallback;
+  const std::string_view text{value};
+  auto parsed{fallback};
+  const auto [end, error]{
+      std::from_chars(text.data(), text.data() + text.size(), parsed)};
+  if (error != std::errc{} || end != text.data() + text.size()) {
+    std::cout << "Ignoring " << name << '=' << text << '\n';
+    return fallback;
+  }
+  return parsed;
+}
+
+// Frames go out compressed with permessage-deflate, which also compresses
+// across frames. websocketpp fixes the memory level at 4; of the window sizes
+// deflate-benchmark measures, 2 KiB shrinks an update nearly as well as the
+// default 32 KiB and the catch-up snapshot to within a fifth of it, while
+// keeping each connection's compressor at about 16 KiB instead of 136 KiB.
+// SBASH64_BUDGET_DEFLATE_WINDOW_BITS, from 8 to 15, overrides it.
+auto deflateWindowBits() -> std::uint8_t {
+  static const auto bits{static_cast<std::uint8_t>(
+      std::clamp(setting("SBASH64_BUDGET_DEFLATE_WINDOW_BITS", 11), 8, 15))};
+  return bits;
+}
+
+// Smaller frames are sent as they are: deflate saves a few bytes at most.
+// SBASH64_BUDGET_COMPRESSION_THRESHOLD overrides it.
+auto compressionThreshold() -> std::string::size_type {
+  static const auto bytes{static_cast<std::string::size_type>(
+      std::max(setting("SBASH64_BUDGET_COMPRESSION_THRESHOLD", 64), 0))};
+  return bytes;
+}
+
+class PermessageDeflate
+    : public websocketpp::extensions::permessage_deflate::enabled<
+          websocketpp::config::asio::permessage_deflate_config> {
+public:
+  PermessageDeflate() {
+    set_server_max_window_bits(
+        deflateWindowBits(),
+        websocketpp::extensions::permessage_deflate::mode::largest);
+  }
+};
+
+struct ServerConfig : websocketpp::config::asio {
+  using type = ServerConfig;
+  using permessage_deflate_type = PermessageDeflate;
+};
+
 class FileStreamFactory : public IoStreamFactory {
 public:
   explicit FileStreamFactory(std::string filePath)
@@ -46,351 +121,1346 @@ private:
   std::string filePath;
 };
 
-void assignMethod(nlohmann::json &json, std::string_view name) {
-  json["method"] = name;
+constexpr auto jsonSubprotocol{"sbash64-budget.json"};
+constexpr auto messagePackSubprotocol{"sbash64-budget.msgpack"};
+
+enum class Encoding { json, messagePack };
+
+// What the server measures about itself, served at /metrics and, for the
+// latest spans, at /trace. Any thread may update it.
+struct Metrics {
+  explicit Metrics(std::chrono::nanoseconds slowThreshold)
+      : tracer{traceCapacity, slowThreshold, std::cout} {}
+
+  static constexpr std::size_t traceCapacity{16 * 1024};
+
+  std::array<LatencyHistogram,
+             static_cast<std::size_t>(Command::Method::closeAccount) + 1>
+      commands;
+  LatencyHistogram requestWait;
+  LatencyHistogram save;
+  LatencyHistogram backup;
+  LatencyHistogram catchUp;
+  std::atomic<std::int_least64_t> outboundFrames{};
+  std::atomic<std::int_least64_t> outboundBytes{};
+  std::atomic<std::uint_least64_t> sentFrames{};
+  std::atomic<std::uint_least64_t> sentBytes{};
+  Tracer tracer;
+};
+
+auto prometheusText(const Metrics &metrics,
+                    const std::vector<InstrumentedBudget::Count> &operations)
+    -> std::string {
+  std::string out;
+  writePrometheusHeader(out, "sbash64_budget_command_seconds", "summary",
+                        "Time to apply a command, by method.");
+  for (std::size_t i{0}; i < metrics.commands.size(); ++i)
+    writePrometheusSummary(
+        out, "sbash64_budget_command_seconds",
+        "method=\"" +
+            std::string{methodName(static_cast<Command::Method>(i))} + '"',
+        metrics.commands.at(i));
+  for (const auto &[name, help, histogram] :
+       {std::tuple{"sbash64_budget_request_wait_seconds",
+                   "Time a request waits for its budget's strand.",
+                   &metrics.requestWait},
+        std::tuple{"sbash64_budget_save_seconds",
+                   "Time to write a budget file.", &metrics.save},
+        std::tuple{"sbash64_budget_backup_seconds",
+                   "Time to copy a budget file to its backup directory.",
+                   &metrics.backup},
+        std::tuple{"sbash64_budget_catch_up_seconds",
+                   "Time to prepare what an opening connection is sent.",
+                   &metrics.catchUp}}) {
+    writePrometheusHeader(out, name, "summary", help);
+    writePrometheusSummary(out, name, "", *histogram);
+  }
+  writePrometheusHeader(out, "sbash64_budget_operations_total", "counter",
+                        "Calls to the budget, by operation.");
+  for (const auto &count : operations)
+    writePrometheusSample(out, "sbash64_budget_operations_total",
+                          "operation=\"" + std::string{count.operation} + '"',
+                          static_cast<double>(count.calls));
+  writePrometheusHeader(out, "sbash64_budget_operation_seconds_total",
+                        "counter",
+                        "Time spent in the budget, by operation.");
+  for (const auto &count : operations)
+    writePrometheusSample(
+        out, "sbash64_budget_operation_seconds_total",
+        "operation=\"" + std::string{count.operation} + '"',
+        std::chrono::duration<double>{count.time}.count());
+  writePrometheusHeader(
+      out, "sbash64_budget_outbound_frames", "gauge",
+      "Frames handed to the I/O threads and not yet written.");
+  writePrometheusSample(out, "sbash64_budget_outbound_frames", "",
+                        static_cast<double>(metrics.outboundFrames.load()));
+  writePrometheusHeader(
+      out, "sbash64_budget_outbound_bytes", "gauge",
+      "Payload bytes handed to the I/O threads and not yet written.");
+  writePrometheusSample(out, "sbash64_budget_outbound_bytes", "",
+                        static_cast<double>(metrics.outboundBytes.load()));
+  writePrometheusHeader(out, "sbash64_budget_sent_frames_total", "counter",
+                        "Frames written to connections.");
+  writePrometheusSample(out, "sbash64_budget_sent_frames_total", "",
+                        static_cast<double>(metrics.sentFrames.load()));
+  writePrometheusHeader(out, "sbash64_budget_sent_bytes_total", "counter",
+                        "Payload bytes written to connections, before "
+                        "compression.");
+  writePrometheusSample(out, "sbash64_budget_sent_bytes_total", "",
+                        static_cast<double>(metrics.sentBytes.load()));
+  return out;
+}
+
+auto frameMessage(const MessageBatch &batch, FrameHeader header,
+                  Encoding encoding)
+    -> websocketpp::server<ServerConfig>::message_ptr {
+  auto message{std::make_shared<ServerConfig::message_type>(
+      ServerConfig::con_msg_manager_type::ptr{},
+      encoding == Encoding::json ? websocketpp::frame::opcode::value::text
+                                 : websocketpp::frame::opcode::value::binary)};
+  if (encoding == Encoding::json)
+    writeJsonFrame(message->get_raw_payload(), header, batch);
+  else
+    writeMessagePackFrame(message->get_raw_payload(), header, batch);
+  message->set_compressed(message->get_payload().size() >=
+                          compressionThreshold());
+  return message;
+}
+
+// The frames on their way to one connection. A tenant's strand posts them
+// here and interrupts the connection, whose interrupt handler, run on the
+// connection's own strand, writes them. That strand is also where websocketpp
+// writes to and drains its send buffer, so only there is the buffer's size
+// read.
+class Wire {
+public:
+  explicit Wire(Metrics &metrics) : metrics{metrics} {}
+
+  ~Wire() {
+    for (const auto &frame : frames)
+      settle(frame->get_payload().size());
+  }
+
+  Wire(const Wire &) = delete;
+  Wire(Wire &&) = delete;
+  auto operator=(const Wire &) -> Wire & = delete;
+  auto operator=(Wire &&) -> Wire & = delete;
+
+  void post(websocketpp::server<ServerConfig>::message_ptr frame) {
+    const auto size{frame->get_payload().size()};
+    queued += size;
+    ++metrics.outboundFrames;
+    metrics.outboundBytes += static_cast<std::int_least64_t>(size);
+    const std::lock_guard lock{mutex};
+    frames.push_back(std::move(frame));
+  }
+
+  // Only the connection's interrupt handler may call write.
+  void write(websocketpp::server<ServerConfig> &server,
+             const websocketpp::connection_hdl &connection) {
+    std::vector<websocketpp::server<ServerConfig>::message_ptr> taken;
+    {
+      const std::lock_guard lock{mutex};
+      taken.swap(frames);
+    }
+    websocketpp::lib::error_code closed;
+    const auto con{server.get_con_from_hdl(connection, closed)};
+    for (const auto &frame : taken) {
+      const auto size{frame->get_payload().size()};
+      const TraceSpan span{metrics.tracer, "send", std::to_string(size)};
+      settle(size);
+      if (!closed && !con->send(frame)) {
+        ++metrics.sentFrames;
+        metrics.sentBytes += size;
+      }
+    }
+    buffered = closed ? 0 : con->get_buffered_amount();
+  }
+
+  // Bytes posted and not yet handed to websocketpp, and those websocketpp had
+  // yet to write when the interrupt handler last ran.
+  [[nodiscard]] auto unsent() const -> std::size_t {
+    return queued + buffered;
+  }
+
+private:
+  void settle(std::size_t size) {
+    queued -= size;
+    --metrics.outboundFrames;
+    metrics.outboundBytes -= static_cast<std::int_least64_t>(size);
+  }
+
+  Metrics &metrics;
+  std::vector<websocketpp::server<ServerConfig>::message_ptr> frames;
+  std::mutex mutex;
+  std::atomic<std::size_t> queued{};
+  std::atomic<std::size_t> buffered{};
+};
+
+// What is on its way to one connection. Frames go out through the
+// connection's wire so that a tenant's strand never writes to a socket. While
+// more than highWater bytes are still unsent, changes wait here instead,
+// collapsed to their latest values, and once those outgrow maxPending the
+// connection is owed a snapshot instead. A stalled client therefore holds on
+// to a bounded amount of memory.
+class Outbox {
+public:
+  static constexpr std::size_t highWater{256 * 1024};
+  static constexpr std::string::size_type maxPending{1024 * 1024};
+
+  Outbox(websocketpp::server<ServerConfig> &server,
+         websocketpp::connection_hdl connection, std::shared_ptr<Wire> wire)
+      : server{server}, connection{std::move(connection)},
+        wire{std::move(wire)} {}
+
+  void send(const websocketpp::server<ServerConfig>::message_ptr &frame) {
+    wire->post(frame);
+    interrupt();
+  }
+
+  void deliver(const websocketpp::server<ServerConfig>::message_ptr &frame,
+               const MessageBatch &changes) {
+    if (owesSnapshot_)
+      return;
+    if (pending_.empty() && !backlogged()) {
+      send(frame);
+      return;
+    }
+    pending_.append(changes);
+    if (pending_.size() > maxPending) {
+      pending_.clear();
+      owesSnapshot_ = true;
+    }
+  }
+
+  // Sends what the connection has been waiting for.
+  void catchUp(const websocketpp::server<ServerConfig>::message_ptr &frame) {
+    send(frame);
+    pending_.clear();
+    owesSnapshot_ = false;
+  }
+
+  [[nodiscard]] auto backlogged() const -> bool {
+    return wire->unsent() >= highWater;
+  }
+
+  // Has the interrupt handler run again, which reads how much websocketpp
+  // has written since.
+  void interrupt() {
+    websocketpp::lib::error_code ignoredBecauseClosing;
+    server.interrupt(connection, ignoredBecauseClosing);
+  }
+
+  [[nodiscard]] auto waiting() const -> bool {
+    return owesSnapshot_ || !pending_.empty();
+  }
+
+  [[nodiscard]] auto owesSnapshot() const -> bool { return owesSnapshot_; }
+
+  [[nodiscard]] auto pending() const -> const MessageBatch & {
+    return pending_;
+  }
+
+private:
+  websocketpp::server<ServerConfig> &server;
+  websocketpp::connection_hdl connection;
+  std::shared_ptr<Wire> wire;
+  MessageBatch pending_;
+  bool owesSnapshot_{};
+};
+
+auto makeView(MessageBatch &batch, Encoding encoding) -> std::unique_ptr<View> {
+  if (encoding == Encoding::json)
+    return std::make_unique<JsonView>(batch);
+  return std::make_unique<MessagePackView>(batch);
 }
 
-void assignAccountIndex(nlohmann::json &json, gsl::index i) {
-  json["accountIndex"] = i;
+// The most recent frames of a channel, so that a reconnecting client can be
+// sent only the frames it missed.
+class History {
+public:
+  explicit History(std::uint_least64_t sequence) : latest{sequence} {}
+
+  void add(std::uint_least64_t sequence,
+           websocketpp::server<ServerConfig>::message_ptr frame) {
+    if (sequence != latest + 1)
+      kept = 0;
+    frames.at(sequence % frames.size()) = std::move(frame);
+    latest = sequence;
+    if (kept < frames.size())
+      ++kept;
+  }
+
+  // The frames after sequence, or nothing when some are no longer kept.
+  [[nodiscard]] auto after(std::uint_least64_t sequence) const
+      -> std::optional<
+          std::vector<websocketpp::server<ServerConfig>::message_ptr>> {
+    if (sequence > latest || latest - sequence > kept)
+      return std::nullopt;
+    std::vector<websocketpp::server<ServerConfig>::message_ptr> missed;
+    for (auto next{sequence + 1}; next <= latest; ++next)
+      missed.push_back(frames.at(next % frames.size()));
+    return missed;
+  }
+
+private:
+  std::array<websocketpp::server<ServerConfig>::message_ptr, 256> frames;
+  std::uint_least64_t latest;
+  std::size_t kept{};
+};
+
+// The connections that negotiated one encoding. Each change is encoded once
+// and the shared message handed to all of them, and the catch-up frame is
+// serialized once for every connection opened before the budget next changes.
+// Only its tenant's strand uses a channel.
+class Channel {
+public:
+  Channel(websocketpp::server<ServerConfig> &server, BudgetPresenter &presenter,
+          Encoding encoding, std::uint_least64_t sequence, Metrics &metrics)
+      : server{server}, presenter{presenter}, metrics{metrics},
+        view{makeView(batch, encoding)}, history{sequence},
+        encoding{encoding} {
+    presenter.attach(view.get());
+  }
+
+  // Resumes a client after the last frame it applied when the frames since
+  // are still kept, and otherwise sends a snapshot of the current sequence.
+  void open(const websocketpp::connection_hdl &connection,
+            std::shared_ptr<Wire> wire,
+            std::optional<std::uint_least64_t> resumeAfter,
+            std::uint_least64_t sequence) {
+    const TraceSpan span{metrics.tracer, "open"};
+    const auto start{std::chrono::steady_clock::now()};
+    auto &outbox{connections
+                     .try_emplace(connection, server, connection,
+                                  std::move(wire))
+                     .first->second};
+    if (const auto missed{resumeAfter ? history.after(*resumeAfter)
+                                      : std::nullopt})
+      for (const auto &frame : *missed)
+        outbox.send(frame);
+    else
+      outbox.send(snapshot(sequence));
+    metrics.catchUp.record(std::chrono::steady_clock::now() - start);
+  }
+
+  void close(const websocketpp::connection_hdl &connection) {
+    connections.erase(connection);
+  }
+
+  [[nodiscard]] auto changed() const -> bool { return !batch.empty(); }
+
+  void flush(std::uint_least64_t sequence) {
+    if (batch.empty())
+      return;
+    const auto message{encode(batch, {sequence, false})};
+    history.add(sequence, message);
+    for (auto &[connection, outbox] : connections)
+      outbox.deliver(message, batch);
+    batch.clear();
+  }
+
+  // Catches up the connections that were waiting and are no longer
+  // backlogged. Returns whether any are still waiting.
+  auto resend(std::uint_least64_t sequence) -> bool {
+    auto waiting{false};
+    for (auto &[connection, outbox] : connections)
+      if (outbox.waiting()) {
+        if (outbox.backlogged()) {
+          outbox.interrupt();
+          waiting = true;
+        } else
+          outbox.catchUp(outbox.owesSnapshot()
+                             ? snapshot(sequence)
+                             : encode(outbox.pending(), {sequence, false}));
+      }
+    return waiting;
+  }
+
+private:
+  auto encode(const MessageBatch &messages, FrameHeader header)
+      -> websocketpp::server<ServerConfig>::message_ptr {
+    const TraceSpan span{metrics.tracer, "encode",
+                         encoding == Encoding::json ? "json" : "msgpack"};
+    return frameMessage(messages, header, encoding);
+  }
+
+  auto snapshot(std::uint_least64_t sequence)
+      -> const websocketpp::server<ServerConfig>::message_ptr & {
+    if (snapshotSequence != sequence) {
+      MessageBatch recorded;
+      const auto recorder{makeView(recorded, encoding)};
+      {
+        const TraceSpan span{metrics.tracer, "catch up"};
+        presenter.catchUp(recorder.get());
+      }
+      snapshot_ = encode(recorded, {sequence, true});
+      snapshotSequence = sequence;
+    }
+    return snapshot_;
+  }
+
+  std::map<websocketpp::connection_hdl, Outbox,
+           std::owner_less<websocketpp::connection_hdl>>
+      connections;
+  websocketpp::server<ServerConfig> &server;
+  BudgetPresenter &presenter;
+  Metrics &metrics;
+  MessageBatch batch;
+  std::unique_ptr<View> view;
+  History history;
+  websocketpp::server<ServerConfig>::message_ptr snapshot_;
+  std::uint_least64_t snapshotSequence{};
+  Encoding encoding;
+};
+
+// Work handed from the I/O threads to a tenant.
+struct Request {
+  enum class Kind { open, close, command, poll };
+
+  Kind kind{};
+  websocketpp::connection_hdl connection{};
+  std::shared_ptr<Wire> wire{};
+  Encoding encoding{};
+  std::optional<std::uint_least64_t> resumeAfter{};
+  Command command{};
+  // The command as received, kept only while recording.
+  std::string payload{};
+  std::chrono::steady_clock::time_point queued{};
+};
+
+auto timestamp(std::chrono::system_clock::time_point time) -> std::string {
+  const auto converted{std::chrono::system_clock::to_time_t(time)};
+  std::stringstream stream;
+  stream << std::put_time(std::localtime(&converted), "%F_%T");
+  return stream.str();
 }
 
-void assignAmount(nlohmann::json &json, std::string_view x) {
-  json["amount"] = x;
+auto backupDirectory(const std::filesystem::path &parentPath,
+                     std::chrono::system_clock::time_point time)
+    -> std::filesystem::path {
+  return parentPath / timestamp(time);
 }
 
-void assignTransactionIndex(nlohmann::json &json, gsl::index i) {
-  json["transactionIndex"] = i;
+auto readFile(const std::filesystem::path &path) -> std::string {
+  std::ifstream file{path, std::ios::binary};
+  std::ostringstream stream;
+  stream << file.rdbuf();
+  return std::move(stream).str();
 }
 
-void send(websocketpp::server<websocketpp::config::asio> &server,
-          websocketpp::connection_hdl connection, const nlohmann::json &json) {
-  server.send(std::move(connection), json.dump(),
-              websocketpp::frame::opcode::value::text);
+// Where a budget is read from and saved to, where its backups go and, when
+// not empty, where its sessions are recorded.
+struct Location {
+  std::filesystem::path budgetFilePath;
+  std::filesystem::path backupParentPath;
+  std::filesystem::path recordingParentPath;
+};
+
+// One budget and everything that serves it. The budget is loaded by the first
+// request and each request is applied on the tenant's strand, so different
+// budgets use the I/O threads in parallel while each one stays
+// single-threaded.
+auto sum(const std::vector<AccountMemoryReport> &reports) -> std::size_t {
+  std::size_t bytes{0};
+  for (const auto &report : reports)
+    bytes += total(report);
+  return bytes;
 }
 
-class BrowserView : public View {
+class Tenant : public std::enable_shared_from_this<Tenant>,
+               public Budget::Observer {
 public:
-  BrowserView(websocketpp::server<websocketpp::config::asio> &server,
-              websocketpp::connection_hdl connection)
-      : connection{std::move(connection)}, server{server} {}
-
-  void setAccountName(gsl::index accountIndex, std::string_view s) override {
-    nlohmann::json json;
-    assignMethod(json, "update account name");
-    assignAccountIndex(json, accountIndex);
-    json["name"] = s;
-    send(server, connection, json);
-  }
-
-  void reorderAccountIndex(gsl::index from, gsl::index to) override {
-    nlohmann::json json;
-    assignMethod(json, "reorder account");
-    assignAccountIndex(json, from);
-    json["newIndex"] = to;
-    send(server, connection, json);
-  }
-
-  void updateAccountAllocation(gsl::index accountIndex,
-                               std::string_view s) override {
-    nlohmann::json json;
-    assignMethod(json, "update account allocation");
-    assignAccountIndex(json, accountIndex);
-    assignAmount(json, s);
-    send(server, connection, json);
-  }
-
-  void updateAccountBalance(gsl::index accountIndex,
-                            std::string_view s) override {
-    nlohmann::json json;
-    assignMethod(json, "update account balance");
-    assignAccountIndex(json, accountIndex);
-    assignAmount(json, s);
-    send(server, connection, json);
-  }
-
-  void putCheckmarkNextToTransactionRow(gsl::index accountIndex,
-                                        gsl::index index) override {
-    nlohmann::json json;
-    assignMethod(json, "check transaction row");
-    assignAccountIndex(json, accountIndex);
-    assignTransactionIndex(json, index);
-    send(server, connection, json);
-  }
-
-  void deleteTransactionRow(gsl::index accountIndex,
-                            gsl::index index) override {
-    nlohmann::json json;
-    assignMethod(json, "delete transaction row");
-    assignAccountIndex(json, accountIndex);
-    assignTransactionIndex(json, index);
-    send(server, connection, json);
-  }
-
-  void addTransactionRow(gsl::index accountIndex, std::string_view amount,
-                         std::string_view date, std::string_view description,
-                         gsl::index index) override {
-    nlohmann::json json;
-    assignMethod(json, "add transaction row");
-    assignAccountIndex(json, accountIndex);
-    assignTransactionIndex(json, index);
-    json["description"] = description;
-    assignAmount(json, amount);
-    json["date"] = date;
-    send(server, connection, json);
-  }
-
-  void removeTransactionRowSelection(gsl::index accountIndex,
-                                     gsl::index index) override {
-    nlohmann::json json;
-    assignMethod(json, "remove transaction row selection");
-    assignAccountIndex(json, accountIndex);
-    assignTransactionIndex(json, index);
-    send(server, connection, json);
-  }
-
-  void addNewAccountTable(std::string_view name, gsl::index index) override {
-    nlohmann::json json;
-    assignMethod(json, "add account table");
-    json["name"] = name;
-    assignAccountIndex(json, index);
-    send(server, connection, json);
-  }
-
-  void deleteAccountTable(gsl::index index) override {
-    nlohmann::json json;
-    assignMethod(json, "delete account table");
-    assignAccountIndex(json, index);
-    send(server, connection, json);
-  }
-
-  void updateNetIncome(std::string_view s) override {
-    nlohmann::json json;
-    assignMethod(json, "update net income");
-    assignAmount(json, s);
-    send(server, connection, json);
-  }
-
-  void markAsSaved() override {
-    nlohmann::json json;
-    assignMethod(json, "mark as saved");
-    send(server, connection, json);
-  }
+  Tenant(websocketpp::server<ServerConfig> &server, Location location,
+         Metrics &metrics)
+      : server{server}, metrics{metrics},
+        strand{asio::make_strand(server.get_io_service())},
+        location{std::move(location)}, incomeAccount{transactionFactory},
+        accountFactory{transactionFactory},
+        budget{incomeAccount, accountFactory}, instrumentedBudget{budget},
+        streamFactory{this->location.budgetFilePath.string()},
+        accountSerializationFactory{transactionSerializationFactory},
+        sessionSerialization{streamFactory, accountSerializationFactory},
+        presenter{incomeAccount},
+        sequence{static_cast<std::uint_least64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count())},
+        jsonChannel{server, presenter, Encoding::json, sequence, metrics},
+        messagePackChannel{server, presenter, Encoding::messagePack,
+                           sequence, metrics} {
+    budget.attach(presenter);
+    budget.attach(*this);
+  }
+
+  // Requests that arrive while the strand is busy are applied before any
+  // channel is flushed, so their changes share a frame.
+  void push(Request request) {
+    request.queued = std::chrono::steady_clock::now();
+    ++pending;
+    requests.push(std::move(request));
+    if (!scheduled.exchange(true, std::memory_order_acq_rel))
+      asio::post(strand, [tenant{shared_from_this()}] { tenant->drain(); });
+  }
+
+  // Decodes a command here, on the I/O thread, rather than on the strand.
+  void receive(const std::string &payload) {
+    push({.kind = Request::Kind::command,
+          .command = jsonCommand(payload),
+          .payload = location.recordingParentPath.empty() ? std::string{}
+                                                          : payload});
+  }
 
-  void markAsUnsaved() override {
-    nlohmann::json json;
-    assignMethod(json, "mark as unsaved");
-    send(server, connection, json);
+  void connect() { ++connections; }
+
+  void disconnect(const websocketpp::connection_hdl &connection) {
+    lastUsed = std::chrono::steady_clock::now().time_since_epoch().count();
+    push({.kind = Request::Kind::close, .connection = connection});
+    --connections;
+  }
+
+  // Neither unsaved changes nor requests yet to be applied are evicted. A
+  // budget that failed to load has nothing to save.
+  [[nodiscard]] auto idleSince() const
+      -> std::optional<std::chrono::steady_clock::time_point> {
+    if (connections != 0 || pending != 0 || (unsaved && !failed_))
+      return std::nullopt;
+    return std::chrono::steady_clock::time_point{
+        std::chrono::steady_clock::duration{lastUsed.load()}};
   }
 
+  [[nodiscard]] auto failed() const -> bool { return failed_; }
+
+  [[nodiscard]] auto operations() const
+      -> std::vector<InstrumentedBudget::Count> {
+    return instrumentedBudget.snapshot();
+  }
+
+  // The heap bytes the budget took when last measured.
+  [[nodiscard]] auto bytes() const -> std::size_t { return bytes_; }
+
+  // Measures again on the strand.
+  void measure() {
+    asio::post(strand, [tenant{shared_from_this()}] {
+      tenant->bytes_ = tenant->measured();
+    });
+  }
+
+  // Measures on the strand, where the budget can be read safely.
+  void reportMemory(
+      std::function<void(std::vector<AccountMemoryReport>)> report) {
+    asio::post(strand, [tenant{shared_from_this()}, report{std::move(report)}] {
+      report(memoryReport(tenant->incomeAccount, tenant->budget,
+                          tenant->presenter));
+    });
+  }
+
+  void notifyThatExpenseAccountHasBeenCreated(Account &,
+                                              std::string_view) override {}
+  void notifyThatNetIncomeHasChanged(USD) override {}
+  void notifyThatExpenseHasMoved(std::string_view, std::string_view,
+                                 TransactionId) override {}
+  void notifyThatHasBeenSaved() override { unsaved = false; }
+  void notifyThatHasUnsavedChanges() override { unsaved = true; }
+
 private:
-  websocketpp::connection_hdl connection;
-  websocketpp::server<websocketpp::config::asio> &server;
+  void drain() {
+    const TraceSpan span{metrics.tracer, "drain",
+                         location.budgetFilePath.filename().string()};
+    scheduled.exchange(false, std::memory_order_acq_rel);
+    if (!loaded && !failed_)
+      load();
+    while (auto request{requests.tryPop()}) {
+      metrics.requestWait.record(std::chrono::steady_clock::now() -
+                                 request->queued);
+      if (failed_)
+        refuse(*request);
+      else
+        handle(*request);
+      --pending;
+    }
+    if (failed_)
+      return;
+    flush();
+    if (recording)
+      recordingFile.flush();
+  }
+
+  // A budget that cannot be read, or whose session cannot be recorded, is not
+  // served at all rather than served and then saved over.
+  void load() {
+    const TraceSpan span{metrics.tracer, "load"};
+    try {
+      ReadsTransactionFromStream::Factory transactionDeserializationFactory;
+      ReadsAccountFromStream::Factory accountDeserializationFactory{
+          transactionDeserializationFactory};
+      ReadsBudgetFromStream budgetDeserialization{
+          streamFactory, accountDeserializationFactory};
+      if (!location.recordingParentPath.empty())
+        startRecording();
+      instrumentedBudget.load(budgetDeserialization);
+      loaded = true;
+      bytes_ = measured();
+    } catch (const std::exception &e) {
+      std::cout << "Could not load " << location.budgetFilePath << ": "
+                << e.what() << '\n';
+      failed_ = true;
+    }
+  }
+
+  void handle(const Request &request) {
+    try {
+      switch (request.kind) {
+      case Request::Kind::open:
+        flush();
+        (request.encoding == Encoding::messagePack ? messagePackChannel
+                                                   : jsonChannel)
+            .open(request.connection, request.wire, request.resumeAfter,
+                  sequence);
+        break;
+      case Request::Kind::close:
+        jsonChannel.close(request.connection);
+        messagePackChannel.close(request.connection);
+        break;
+      case Request::Kind::command:
+        if (recording)
+          recording->write(
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  request.queued - recordingStart),
+              request.payload);
+        execute(request.command);
+        break;
+      case Request::Kind::poll:
+        pollScheduled = false;
+        break;
+      }
+    } catch (const std::exception &e) {
+      std::cout << e.what() << '\n';
+    }
+  }
+
+  // Closes each connection to a budget that failed to load, which leaves the
+  // tenant idle so that the next connection after its eviction tries again.
+  void refuse(const Request &request) {
+    if (request.kind != Request::Kind::open)
+      return;
+    websocketpp::lib::error_code ignored;
+    server.close(request.connection,
+                 websocketpp::close::status::try_again_later,
+                 "budget unavailable", ignored);
+  }
+
+  [[nodiscard]] auto measured() -> std::size_t {
+    return sum(memoryReport(incomeAccount, budget, presenter));
+  }
+
+  // Starts a file named for the time, in which the budget as it is about to
+  // be loaded is followed by each command applied to it.
+  void startRecording() {
+    std::filesystem::create_directories(location.recordingParentPath);
+    recordingFile.open(location.recordingParentPath /
+                           (timestamp(std::chrono::system_clock::now()) +
+                            ".recording"),
+                       std::ios::binary);
+    recordingStart = std::chrono::steady_clock::now();
+    recording.emplace(recordingFile, readFile(location.budgetFilePath));
+  }
+
+  void flush() {
+    const TraceSpan span{metrics.tracer, "flush"};
+    if (jsonChannel.changed() || messagePackChannel.changed()) {
+      ++sequence;
+      jsonChannel.flush(sequence);
+      messagePackChannel.flush(sequence);
+    }
+    const auto jsonWaiting{jsonChannel.resend(sequence)};
+    const auto messagePackWaiting{messagePackChannel.resend(sequence)};
+    if ((jsonWaiting || messagePackWaiting) && !pollScheduled) {
+      pollScheduled = true;
+      server.set_timer(50, [tenant{shared_from_this()}](
+                               const websocketpp::lib::error_code &) {
+        tenant->push({.kind = Request::Kind::poll});
+      });
+    }
+  }
+
+  void execute(const Command &command) {
+    const TraceSpan span{metrics.tracer, "apply",
+                         std::string{methodName(command.method)}};
+    const auto start{std::chrono::steady_clock::now()};
+    if (command.method == Command::Method::save)
+      save();
+    else
+      apply(instrumentedBudget, command);
+    metrics.commands.at(static_cast<std::size_t>(command.method))
+        .record(std::chrono::steady_clock::now() - start);
+  }
+
+  void save() {
+    const auto start{std::chrono::steady_clock::now()};
+    backUp();
+    const auto backedUp{std::chrono::steady_clock::now()};
+    metrics.backup.record(backedUp - start);
+    {
+      const TraceSpan span{metrics.tracer, "write"};
+      instrumentedBudget.save(sessionSerialization);
+    }
+    metrics.save.record(std::chrono::steady_clock::now() - backedUp);
+  }
+
+  void backUp() {
+    const TraceSpan span{metrics.tracer, "backup"};
+    if (backupDirectory_.empty()) {
+      backupDirectory_ = backupDirectory(location.backupParentPath,
+                                         std::chrono::system_clock::now());
+      std::filesystem::create_directories(backupDirectory_);
+    }
+    if (std::filesystem::exists(location.budgetFilePath)) {
+      std::stringstream backupFileName;
+      backupFileName << ++backupCount << ".txt";
+      std::filesystem::copy(location.budgetFilePath,
+                            backupDirectory_ / backupFileName.str());
+    }
+  }
+
+  websocketpp::server<ServerConfig> &server;
+  Metrics &metrics;
+  asio::strand<asio::io_context::executor_type> strand;
+  Location location;
+  ObservableTransactionInMemory::Factory transactionFactory;
+  AccountInMemory incomeAccount;
+  AccountInMemory::Factory accountFactory;
+  BudgetInMemory budget;
+  InstrumentedBudget instrumentedBudget;
+  FileStreamFactory streamFactory;
+  WritesTransactionToStream::Factory transactionSerializationFactory;
+  WritesAccountToStream::Factory accountSerializationFactory;
+  WritesBudgetToStream sessionSerialization;
+  BudgetPresenter presenter;
+  // Starts past any sequence of an earlier instance of this budget, so that
+  // its clients are caught up rather than resumed.
+  std::uint_least64_t sequence;
+  Channel jsonChannel;
+  Channel messagePackChannel;
+  MpscQueue<Request> requests;
+  std::filesystem::path backupDirectory_;
+  std::uintmax_t backupCount{};
+  std::ofstream recordingFile;
+  std::optional<RecordingWriter> recording;
+  std::chrono::steady_clock::time_point recordingStart{};
+  std::atomic<bool> scheduled{};
+  std::atomic<bool> unsaved{};
+  std::atomic<bool> failed_{};
+  std::atomic<int> connections{};
+  std::atomic<std::size_t> bytes_{};
+  // Requests pushed and not yet applied.
+  std::atomic<int> pending{};
+  std::atomic<std::chrono::steady_clock::rep> lastUsed{
+      std::chrono::steady_clock::now().time_since_epoch().count()};
+  bool loaded{};
+  bool pollScheduled{};
 };
-} // namespace
 
-static auto backupDirectory(const std::filesystem::path &parentPath,
-                            std::chrono::system_clock::time_point time)
-    -> std::filesystem::path {
-  const auto converted{std::chrono::system_clock::to_time_t(time)};
-  std::stringstream backupDirectory;
-  backupDirectory << std::put_time(std::localtime(&converted), "%F_%T");
-  return parentPath / backupDirectory.str();
+// The loaded tenants by budget file. A tenant with open connections, queued
+// requests or unsaved changes stays loaded; any other is evicted once idle
+// for idleTimeout, or sooner, least recently used first, while the loaded
+// budgets take more than maxLoadedBytes of heap as last measured, which each
+// eviction pass measures again. One that failed to load is evicted as soon as
+// it is idle. Only budgets whose file exists are located, so the budgets that
+// can cycle through here are the ones put in place on the server.
+class Tenants {
+public:
+  Tenants(websocketpp::server<ServerConfig> &server, Metrics &metrics,
+          std::function<std::optional<Location>(std::string_view name)> locate)
+      : server{server}, metrics{metrics}, locate{std::move(locate)} {}
+
+  [[nodiscard]] auto hosts(std::string_view name) const -> bool {
+    return locate(name).has_value();
+  }
+
+  // Counts a connection to the named budget, loading it if needed, or returns
+  // null when the budget isn't hosted. The connection disconnects through the
+  // tenant returned, which stays the same even if the file goes away.
+  auto connect(std::string_view name) -> std::shared_ptr<Tenant> {
+    const auto location{locate(name)};
+    if (!location)
+      return nullptr;
+    std::lock_guard lock{mutex};
+    auto &tenant{loaded[location->budgetFilePath.string()]};
+    if (!tenant)
+      tenant = std::make_shared<Tenant>(server, *location, metrics);
+    tenant->connect();
+    return tenant;
+  }
+
+  void evict(std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock{mutex};
+    std::multimap<std::chrono::steady_clock::time_point, std::string> idle;
+    for (const auto &[path, tenant] : loaded)
+      if (const auto since{tenant->idleSince()})
+        idle.emplace(*since, path);
+    std::size_t bytes{0};
+    for (const auto &[path, tenant] : loaded)
+      bytes += tenant->bytes();
+    for (const auto &[since, path] : idle)
+      if (const auto &tenant{loaded.at(path)};
+          bytes > maxLoadedBytes || tenant->failed() ||
+          now - since >= idleTimeout) {
+        bytes -= tenant->bytes();
+        add(evicted, tenant->operations());
+        loaded.erase(path);
+      }
+    for (const auto &[path, tenant] : loaded)
+      tenant->measure();
+  }
+
+  // The budget operations of every tenant ever loaded, so that the totals
+  // never go down.
+  auto operations() -> std::vector<InstrumentedBudget::Count> {
+    std::lock_guard lock{mutex};
+    auto total{evicted};
+    for (const auto &[path, tenant] : loaded)
+      add(total, tenant->operations());
+    return total;
+  }
+
+  // Calls done, on some strand, once every loaded tenant has reported.
+  void reportMemory(std::function<void(const std::string &)> done) {
+    std::vector<std::pair<std::string, std::shared_ptr<Tenant>>> reporting;
+    {
+      std::lock_guard lock{mutex};
+      for (const auto &[path, tenant] : loaded)
+        reporting.emplace_back(
+            std::filesystem::path{path}.filename().string(), tenant);
+    }
+    const auto gathered{
+        std::make_shared<MemoryReports>(reporting.size(), std::move(done))};
+    if (reporting.empty())
+      gathered->finish();
+    for (const auto &[name, tenant] : reporting)
+      tenant->reportMemory(
+          [gathered, name{name}](std::vector<AccountMemoryReport> reports) {
+            gathered->add(name, std::move(reports));
+          });
+  }
+
+  static constexpr std::chrono::minutes idleTimeout{10};
+  static constexpr std::size_t maxLoadedBytes{std::size_t{256} << 20U};
+
+private:
+  // The tenants' reports as they come in from their strands.
+  class MemoryReports {
+  public:
+    MemoryReports(std::size_t expected,
+                  std::function<void(const std::string &)> done)
+        : done{std::move(done)}, remaining{expected} {}
+
+    void add(std::string name, std::vector<AccountMemoryReport> reports) {
+      std::lock_guard lock{mutex};
+      budgets.emplace_back(std::move(name), std::move(reports));
+      if (--remaining == 0)
+        finish();
+    }
+
+    // Writes {"allocator":{...},"budgets":[{"name":...,"memory":{...}}]},
+    // the largest budget first.
+    void finish() {
+      std::sort(budgets.begin(), budgets.end(),
+                [](const auto &a, const auto &b) {
+                  return sum(a.second) > sum(b.second);
+                });
+      std::string out{"{"};
+      if (const auto allocator{allocatorMemory()})
+        out += R"("allocator":{"inUse":)" + std::to_string(allocator->inUse) +
+               R"(,"free":)" + std::to_string(allocator->free) + "},";
+      out += R"("budgets":[)";
+      for (const auto &[name, reports] : budgets) {
+        if (out.back() == '}')
+          out += ',';
+        out += R"({"name":)";
+        writeJsonString(out, name);
+        out += R"(,"memory":)";
+        writeMemoryReport(out, reports);
+        out += '}';
+      }
+      out += "]}";
+      done(out);
+    }
+
+  private:
+    std::function<void(const std::string &)> done;
+    std::vector<std::pair<std::string, std::vector<AccountMemoryReport>>>
+        budgets;
+    std::size_t remaining;
+    std::mutex mutex;
+  };
+
+  static void add(std::vector<InstrumentedBudget::Count> &total,
+                  const std::vector<InstrumentedBudget::Count> &counts) {
+    if (total.empty()) {
+      total = counts;
+      return;
+    }
+    for (std::size_t i{0}; i < total.size(); ++i) {
+      total.at(i).calls += counts.at(i).calls;
+      total.at(i).time += counts.at(i).time;
+    }
+  }
+
+  std::map<std::string, std::shared_ptr<Tenant>, std::less<>> loaded;
+  std::vector<InstrumentedBudget::Count> evicted;
+  std::mutex mutex;
+  websocketpp::server<ServerConfig> &server;
+  Metrics &metrics;
+  std::function<std::optional<Location>(std::string_view name)> locate;
+};
+
+auto isBudgetName(std::string_view name) -> bool {
+  return !name.empty() &&
+         std::all_of(name.begin(), name.end(), [](char c) {
+           return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                  (c >= '0' && c <= '9') || c == '-' || c == '_';
+         });
 }
 
-static auto date(std::string_view s) -> Date {
-  Date date{};
-  std::stringstream stream{std::string{s}};
-  int year = 0;
-  int month = 0;
-  int day = 0;
-  if (s.find('-') != std::string_view::npos) {
-    stream >> year;
-    stream.get();
-    stream >> month;
-    stream.get();
-    stream >> day;
-  } else {
-    stream >> month;
-    stream.get();
-    stream >> day;
-    stream.get();
-    stream >> year;
-  }
-  date.month = Month{month};
-  date.day = day;
-  date.year = year;
-  return date;
+// The budget name of a resource such as "/household?resume=3".
+auto budgetName(std::string_view resource) -> std::string_view {
+  resource = resource.substr(0, resource.find('?'));
+  if (!resource.empty() && resource.front() == '/')
+    resource.remove_prefix(1);
+  return resource;
 }
 
-static auto transaction(const nlohmann::json &json) -> Transaction {
-  return {usd(json["amount"].get<std::string>()),
-          json["description"].get<std::string>(),
-          date(json["date"].get<std::string>())};
+// The last sequence applied by a reconnecting client, as in
+// "/household?resume=3".
+auto resumeAfter(std::string_view resource)
+    -> std::optional<std::uint_least64_t> {
+  constexpr std::string_view parameter{"resume="};
+  const auto query{resource.find('?')};
+  if (query == std::string_view::npos)
+    return std::nullopt;
+  auto found{resource.find(parameter, query)};
+  while (found != std::string_view::npos && resource[found - 1] != '?' &&
+         resource[found - 1] != '&')
+    found = resource.find(parameter, found + 1);
+  if (found == std::string_view::npos)
+    return std::nullopt;
+  const auto *const begin{resource.data() + found + parameter.size()};
+  std::uint_least64_t sequence = 0;
+  const auto [end, error]{
+      std::from_chars(begin, resource.data() + resource.size(), sequence)};
+  if (error != std::errc{})
+    return std::nullopt;
+  return sequence;
 }
 
-static auto methodIs(const nlohmann::json &json, std::string_view method)
-    -> bool {
-  return json["method"].get<std::string>() == method;
+auto gzip(std::string_view data) -> std::string {
+  z_stream stream{};
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16,
+                   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+    return {};
+  std::string compressed(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef *>(compressed.data());
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  const auto result{deflate(&stream, Z_FINISH)};
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return result == Z_STREAM_END ? compressed : std::string{};
 }
 
-static auto accountName(const nlohmann::json &json) -> std::string {
-  return json["name"].get<std::string>();
+auto brotli([[maybe_unused]] std::string_view data) -> std::string {
+#ifdef SBASH64_BUDGET_HAS_BROTLI
+  auto size{BrotliEncoderMaxCompressedSize(data.size())};
+  if (size == 0)
+    return {};
+  std::string compressed(size, '\0');
+  if (BrotliEncoderCompress(
+          BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+          data.size(), reinterpret_cast<const std::uint8_t *>(data.data()),
+          &size, reinterpret_cast<std::uint8_t *>(compressed.data())) ==
+      BROTLI_FALSE)
+    return {};
+  compressed.resize(size);
+  return compressed;
+#else
+  return {};
+#endif
 }
 
-static auto accountIsIncome(const nlohmann::json &json) -> bool {
-  return accountName(json) == "Income";
+// FNV-1a, which is plenty to tell versions of a file apart.
+auto entityTag(std::string_view data) -> std::string {
+  std::uint_least64_t hash{0xcbf29ce484222325};
+  for (const auto c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+  std::array<char, 16> digits{};
+  const auto [end, error]{std::to_chars(
+      digits.data(), digits.data() + digits.size(), hash, 16)};
+  return '"' + std::string(digits.data(), end) + '"';
 }
 
-static void
-handleMessage(Budget &budget, std::uintmax_t &backupCount,
-              std::string_view budgetFilePath,
-              const std::filesystem::path &backupDirectory,
-              WritesBudgetToStream &sessionSerialization,
-              const websocketpp::server<websocketpp::config::asio>::message_ptr
-                  &message) {
-  // brace-initialization seems to fail here
-  const auto json = nlohmann::json::parse(message->get_payload());
-  if (methodIs(json, "add transaction"))
-    if (accountIsIncome(json))
-      budget.addIncome(transaction(json));
-    else
-      budget.addExpense(accountName(json), transaction(json));
-  else if (methodIs(json, "remove transaction"))
-    if (accountIsIncome(json))
-      budget.removeIncome(transaction(json));
-    else
-      budget.removeExpense(accountName(json), transaction(json));
-  else if (methodIs(json, "verify transaction"))
-    if (accountIsIncome(json))
-      budget.verifyIncome(transaction(json));
-    else
-      budget.verifyExpense(accountName(json), transaction(json));
-  else if (methodIs(json, "transfer"))
-    budget.transferTo(accountName(json),
-                      usd(json["amount"].get<std::string>()));
-  else if (methodIs(json, "reduce"))
-    budget.reduce();
-  else if (methodIs(json, "restore"))
-    budget.restore();
-  else if (methodIs(json, "allocate"))
-    budget.allocate(accountName(json), usd(json["amount"].get<std::string>()));
-  else if (methodIs(json, "rename account"))
-    budget.renameAccount(accountName(json), json["newName"].get<std::string>());
-  else if (methodIs(json, "create account"))
-    budget.createAccount(json["newName"].get<std::string>());
-  else if (methodIs(json, "remove account"))
-    budget.removeAccount(accountName(json));
-  else if (methodIs(json, "close account"))
-    budget.closeAccount(accountName(json));
-  else if (methodIs(json, "save")) {
-    std::stringstream backupFileName;
-    backupFileName << ++backupCount << ".txt";
-    std::filesystem::copy(budgetFilePath,
-                          backupDirectory / backupFileName.str());
-    budget.save(sessionSerialization);
+// A file as served, along with its compressed variants when those are
+// smaller.
+struct Asset {
+  std::string contentType;
+  std::string entityTag;
+  std::string identity;
+  std::string gzip;
+  std::string brotli;
+};
+
+auto loadAsset(const std::filesystem::path &path, std::string contentType)
+    -> std::shared_ptr<const Asset> {
+  auto asset{std::make_shared<Asset>()};
+  asset->contentType = std::move(contentType);
+  asset->identity = readFile(path);
+  asset->entityTag = entityTag(asset->identity);
+  asset->gzip = gzip(asset->identity);
+  if (asset->gzip.size() >= asset->identity.size())
+    asset->gzip.clear();
+  asset->brotli = brotli(asset->identity);
+  if (asset->brotli.size() >= asset->identity.size())
+    asset->brotli.clear();
+  return asset;
+}
+
+auto lastWriteTime(const std::filesystem::path &path)
+    -> std::filesystem::file_time_type {
+  std::error_code missing;
+  return std::filesystem::last_write_time(path, missing);
+}
+
+// Static files held in memory so that serving them never touches the disk.
+// Only refresh, run periodically, checks whether a file has changed.
+class Assets {
+public:
+  void add(std::string name, std::filesystem::path path,
+           std::string contentType) {
+    const auto modified{lastWriteTime(path)};
+    auto asset{loadAsset(path, contentType)};
+    entries.try_emplace(std::move(name),
+                        Entry{std::move(path), std::move(contentType),
+                              modified, std::move(asset)});
+  }
+
+  void refresh() {
+    for (auto &[name, entry] : entries) {
+      const auto modified{lastWriteTime(entry.path)};
+      if (modified == entry.modified)
+        continue;
+      entry.modified = modified;
+      auto asset{loadAsset(entry.path, entry.contentType)};
+      const std::lock_guard lock{mutex};
+      entry.asset = std::move(asset);
+    }
+  }
+
+  [[nodiscard]] auto find(std::string_view name) const
+      -> std::shared_ptr<const Asset> {
+    const auto found{entries.find(name)};
+    if (found == entries.end())
+      return nullptr;
+    const std::lock_guard lock{mutex};
+    return found->second.asset;
+  }
+
+private:
+  struct Entry {
+    std::filesystem::path path;
+    std::string contentType;
+    std::filesystem::file_time_type modified;
+    std::shared_ptr<const Asset> asset;
+  };
+
+  std::map<std::string, Entry, std::less<>> entries;
+  mutable std::mutex mutex;
+};
+
+auto trim(std::string_view s) -> std::string_view {
+  const auto first{s.find_first_not_of(" \t")};
+  if (first == std::string_view::npos)
+    return {};
+  return s.substr(first, s.find_last_not_of(" \t") - first + 1);
+}
+
+// Calls f with each trimmed element of a comma-separated header value until
+// f returns true.
+template <typename F> auto anyListed(std::string_view header, F f) -> bool {
+  while (!header.empty()) {
+    const auto comma{header.find(',')};
+    if (f(trim(header.substr(0, comma))))
+      return true;
+    if (comma == std::string_view::npos)
+      break;
+    header.remove_prefix(comma + 1);
   }
+  return false;
 }
-} // namespace sbash64::budget
 
-static void setBody(
-    const std::string &filePath,
-    const std::shared_ptr<websocketpp::connection<websocketpp::config::asio>>
-        &con,
-    const std::string &contentType = {}) {
-  std::ifstream response{filePath};
-  std::ostringstream stream;
-  stream << response.rdbuf();
-  con->set_body(stream.str());
-  if (!contentType.empty())
-    con->append_header("Content-Type", contentType);
+// Whether an Accept-Encoding header allows a content coding, ignoring
+// preferences other than "q=0".
+auto accepts(std::string_view acceptEncoding, std::string_view coding)
+    -> bool {
+  return anyListed(acceptEncoding, [coding](std::string_view element) {
+    const auto semicolon{element.find(';')};
+    const auto name{trim(element.substr(0, semicolon))};
+    if (name.size() != coding.size() ||
+        !std::equal(name.begin(), name.end(), coding.begin(),
+                    [](char a, char b) {
+                      return std::tolower(static_cast<unsigned char>(a)) ==
+                             std::tolower(static_cast<unsigned char>(b));
+                    }))
+      return false;
+    if (semicolon == std::string_view::npos)
+      return true;
+    const auto parameter{trim(element.substr(semicolon + 1))};
+    return !parameter.starts_with("q=0") ||
+           parameter.find_first_not_of("0.", 2) != std::string_view::npos;
+  });
+}
+
+auto matches(std::string_view ifNoneMatch, std::string_view entityTag)
+    -> bool {
+  return anyListed(ifNoneMatch, [entityTag](std::string_view element) {
+    if (element.starts_with("W/"))
+      element.remove_prefix(2);
+    return element == "*" || element == entityTag;
+  });
+}
+
+// Browsers revalidate on every visit, which costs a 304 while the file is
+// unchanged; the page refers to its script and styles by fixed names.
+void serve(const Asset &asset,
+           const std::shared_ptr<websocketpp::connection<ServerConfig>> &con) {
+  const auto &acceptEncoding{con->get_request_header("Accept-Encoding")};
+  const std::string *body{&asset.identity};
+  std::string_view coding;
+  if (!asset.brotli.empty() && accepts(acceptEncoding, "br")) {
+    body = &asset.brotli;
+    coding = "br";
+  } else if (!asset.gzip.empty() && accepts(acceptEncoding, "gzip")) {
+    body = &asset.gzip;
+    coding = "gzip";
+  }
+  // Each encoding is a different representation and needs its own tag.
+  auto tag{asset.entityTag};
+  if (!coding.empty())
+    tag.insert(tag.size() - 1, "-" + std::string{coding});
+  con->append_header("Cache-Control", "no-cache");
+  con->append_header("Vary", "Accept-Encoding");
+  con->append_header("ETag", tag);
+  if (matches(con->get_request_header("If-None-Match"), tag)) {
+    con->set_status(websocketpp::http::status_code::not_modified);
+    return;
+  }
+  con->append_header("Content-Type", asset.contentType);
+  if (!coding.empty())
+    con->append_header("Content-Encoding", std::string{coding});
+  con->set_body(*body);
+  con->set_status(websocketpp::http::status_code::ok);
+}
+
+void scheduleAssetRefresh(websocketpp::server<ServerConfig> &server,
+                          Assets &assets) {
+  server.set_timer(std::chrono::milliseconds{std::chrono::seconds{1}}.count(),
+                   [&server, &assets](const websocketpp::lib::error_code &e) {
+                     if (e)
+                       return;
+                     assets.refresh();
+                     scheduleAssetRefresh(server, assets);
+                   });
+}
+
+void scheduleEviction(websocketpp::server<ServerConfig> &server,
+                      Tenants &tenants) {
+  server.set_timer(std::chrono::milliseconds{std::chrono::minutes{1}}.count(),
+                   [&server, &tenants](const websocketpp::lib::error_code &e) {
+                     if (e)
+                       return;
+                     tenants.evict(std::chrono::steady_clock::now());
+                     scheduleEviction(server, tenants);
+                   });
+}
+} // namespace
+
+static void run(websocketpp::server<ServerConfig> &server) {
+  try {
+    server.run();
+  } catch (websocketpp::exception const &e) {
+    std::cout << e.what() << '\n';
+  } catch (const std::exception &e) {
+    std::cout << e.what() << '\n';
+  } catch (...) {
+    std::cout << "other exception" << '\n';
+  }
 }
+} // namespace sbash64::budget
 
+// Serves the budget file given as the first argument, or, when that is a
+// directory, every budget in it: the page at /<name> edits <directory>/<name>,
+// which must already exist. An empty file starts a new budget.
+// An optional fourth argument names a directory in which every session is
+// recorded for sbash64-budget-replay.
+// Work on a budget that takes longer than SBASH64_BUDGET_SLOW_MILLISECONDS,
+// one second by default, is logged with its spans, and the latest spans are
+// served at /trace. SBASH64_BUDGET_DEFLATE_WINDOW_BITS and
+// SBASH64_BUDGET_COMPRESSION_THRESHOLD tune how frames are compressed.
 int main(int argc, char *argv[]) {
   if (argc < 4) {
     return EXIT_FAILURE;
   }
-  const std::string budgetFilePath{argv[1]};
+  const std::filesystem::path budgetPath{argv[1]};
   const std::filesystem::path backupParentPath{argv[2]};
   const auto port{std::stoi(argv[3])};
+  const std::filesystem::path recordingParentPath{argc > 4 ? argv[4] : ""};
+  const auto hostsDirectory{std::filesystem::is_directory(budgetPath)};
+
+  // Read here rather than in the first handshake that needs them.
+  sbash64::budget::deflateWindowBits();
+  sbash64::budget::compressionThreshold();
+  websocketpp::server<sbash64::budget::ServerConfig> server;
+  sbash64::budget::Metrics metrics{std::chrono::milliseconds{
+      sbash64::budget::setting("SBASH64_BUDGET_SLOW_MILLISECONDS", 1000)}};
+  sbash64::budget::Tenants tenants{
+      server, metrics,
+      [&budgetPath, &backupParentPath, &recordingParentPath,
+       hostsDirectory](std::string_view name)
+          -> std::optional<sbash64::budget::Location> {
+        if (!hostsDirectory)
+          return sbash64::budget::Location{budgetPath, backupParentPath,
+                                           recordingParentPath};
+        if (!sbash64::budget::isBudgetName(name) ||
+            !std::filesystem::is_regular_file(budgetPath / name))
+          return std::nullopt;
+        return sbash64::budget::Location{
+            budgetPath / name, backupParentPath / name,
+            recordingParentPath.empty() ? recordingParentPath
+                                        : recordingParentPath / name};
+      }};
+
+  sbash64::budget::Assets assets;
+  assets.add("index.html", "index.html", "text/html; charset=utf-8");
+  assets.add("main.js", "main.js", "text/javascript");
+  assets.add("styles.css", "styles.css", "text/css");
 
-  sbash64::budget::ObservableTransactionInMemory::Factory transactionFactory;
-  sbash64::budget::AccountInMemory incomeAccount{transactionFactory};
-  sbash64::budget::AccountInMemory::Factory accountFactory{transactionFactory};
-  sbash64::budget::BudgetInMemory budget{incomeAccount, accountFactory};
-  sbash64::budget::FileStreamFactory streamFactory{budgetFilePath};
-  sbash64::budget::WritesTransactionToStream::Factory
-      transactionRecordSerializationFactory;
-  sbash64::budget::WritesAccountToStream::Factory accountSerializationFactory{
-      transactionRecordSerializationFactory};
-  sbash64::budget::WritesBudgetToStream sessionSerialization{
-      streamFactory, accountSerializationFactory};
-  sbash64::budget::ReadsTransactionFromStream::Factory
-      transactionRecordDeserializationFactory;
-  sbash64::budget::ReadsAccountFromStream::Factory
-      accountDeserializationFactory{transactionRecordDeserializationFactory};
-  sbash64::budget::ReadsBudgetFromStream budgetDeserialization{
-      streamFactory, accountDeserializationFactory};
-  sbash64::budget::BudgetPresenter presenter{incomeAccount};
-  std::filesystem::path backupDirectory{sbash64::budget::backupDirectory(
-      backupParentPath, std::chrono::system_clock::now())};
-  std::uintmax_t backupCount = 0;
-  budget.attach(presenter);
-  budget.load(budgetDeserialization);
-  std::filesystem::create_directory(backupDirectory);
-
-  std::map<void *, std::unique_ptr<sbash64::budget::BrowserView>> views;
-  std::mutex budgetMutex;
-
-  websocketpp::server<websocketpp::config::asio> server;
   server.clear_access_channels(websocketpp::log::alevel::all);
   server.set_access_channels(websocketpp::log::alevel::access_core);
   try {
     server.init_asio();
-    server.set_open_handler([&server, &presenter, &views, &budgetMutex](
-                                const websocketpp::connection_hdl &connection) {
-      std::lock_guard lock{budgetMutex};
-      auto view =
-          std::make_unique<sbash64::budget::BrowserView>(server, connection);
-      presenter.add(view.get());
-      views[connection.lock().get()] = std::move(view);
-    });
     server.set_fail_handler([&server](websocketpp::connection_hdl connection) {
       const auto con = server.get_con_from_hdl(std::move(connection));
       std::cout << "Fail handler: " << con->get_ec() << " "
                 << con->get_ec().message() << '\n';
     });
-    server.set_close_handler(
-        [&views, &presenter,
-         &budgetMutex](const websocketpp::connection_hdl &connection) {
-          std::lock_guard lock{budgetMutex};
-          auto node{views.extract(connection.lock().get())};
-          presenter.remove(node.mapped().get());
-        });
-    server.set_message_handler(
-        [&budget, &backupCount, &budgetFilePath, &backupDirectory,
-         &sessionSerialization, &budgetMutex](
-            const websocketpp::connection_hdl &,
-            const websocketpp::server<websocketpp::config::asio>::message_ptr
-                &message) {
-          std::lock_guard lock{budgetMutex};
-          sbash64::budget::handleMessage(budget, backupCount, budgetFilePath,
-                                         backupDirectory, sessionSerialization,
-                                         message);
-        });
-    server.set_http_handler([&server](websocketpp::connection_hdl connection) {
+    // The tenant is counted from here, so every handler of the connection
+    // after this one holds it.
+    server.set_validate_handler([&server, &tenants, &metrics](
+                                    const websocketpp::connection_hdl
+                                        &connection) {
+      const auto con = server.get_con_from_hdl(connection);
+      const auto tenant{
+          tenants.connect(sbash64::budget::budgetName(con->get_resource()))};
+      if (!tenant) {
+        con->set_status(websocketpp::http::status_code::not_found);
+        return false;
+      }
+      for (const auto &subprotocol : con->get_requested_subprotocols())
+        if (subprotocol == sbash64::budget::messagePackSubprotocol ||
+            subprotocol == sbash64::budget::jsonSubprotocol) {
+          con->select_subprotocol(subprotocol);
+          break;
+        }
+      con->set_fail_handler(
+          [&server, tenant](const websocketpp::connection_hdl &failed) {
+            const auto failedCon = server.get_con_from_hdl(failed);
+            std::cout << "Fail handler: " << failedCon->get_ec() << " "
+                      << failedCon->get_ec().message() << '\n';
+            tenant->disconnect(failed);
+          });
+      con->set_close_handler(
+          [tenant](const websocketpp::connection_hdl &closed) {
+            tenant->disconnect(closed);
+          });
+      con->set_message_handler(
+          [tenant](const websocketpp::connection_hdl &,
+                   const websocketpp::server<
+                       sbash64::budget::ServerConfig>::message_ptr &message) {
+            tenant->receive(message->get_payload());
+          });
+      con->set_open_handler([&server, &metrics, tenant](
+                                const websocketpp::connection_hdl &opened) {
+        const auto openedCon = server.get_con_from_hdl(opened);
+        const auto wire{std::make_shared<sbash64::budget::Wire>(metrics)};
+        openedCon->set_interrupt_handler(
+            [&server, wire](const websocketpp::connection_hdl &interrupted) {
+              wire->write(server, interrupted);
+            });
+        tenant->push(
+            {.kind = sbash64::budget::Request::Kind::open,
+             .connection = opened,
+             .wire = wire,
+             .encoding = openedCon->get_subprotocol() ==
+                                 sbash64::budget::messagePackSubprotocol
+                             ? sbash64::budget::Encoding::messagePack
+                             : sbash64::budget::Encoding::json,
+             .resumeAfter =
+                 sbash64::budget::resumeAfter(openedCon->get_resource())});
+      });
+      return true;
+    });
+    server.set_http_handler([&server, &tenants, &assets, &metrics](
+                                websocketpp::connection_hdl connection) {
       const auto con = server.get_con_from_hdl(std::move(connection));
-      if (con->get_resource() == "/" || con->get_resource() == "/index.html")
-        setBody("index.html", con);
-      else if (con->get_resource() == "/main.js")
-        setBody("main.js", con, "text/javascript");
-      else if (con->get_resource() == "/styles.css")
-        setBody("styles.css", con, "text/css");
-      con->set_status(websocketpp::http::status_code::ok);
+      // Shadows budgets named "memory", "metrics" and "trace".
+      if (con->get_resource() == "/memory") {
+        con->defer_http_response();
+        tenants.reportMemory([con](const std::string &body) {
+          con->append_header("Content-Type", "application/json");
+          con->set_body(body);
+          con->set_status(websocketpp::http::status_code::ok);
+          con->send_http_response();
+        });
+        return;
+      }
+      if (con->get_resource() == "/trace") {
+        std::string body;
+        sbash64::budget::writeChromeTrace(body, metrics.tracer.events());
+        con->append_header("Content-Type", "application/json");
+        con->set_body(body);
+        con->set_status(websocketpp::http::status_code::ok);
+        return;
+      }
+      if (con->get_resource() == "/metrics") {
+        con->append_header("Content-Type",
+                           "text/plain; version=0.0.4; charset=utf-8");
+        con->set_body(
+            sbash64::budget::prometheusText(metrics, tenants.operations()));
+        con->set_status(websocketpp::http::status_code::ok);
+        return;
+      }
+      const auto name{sbash64::budget::budgetName(con->get_resource())};
+      auto asset{assets.find(name)};
+      if (!asset && (name.empty() || tenants.hosts(name)))
+        asset = assets.find("index.html");
+      if (asset)
+        sbash64::budget::serve(*asset, con);
+      else
+        con->set_status(websocketpp::http::status_code::not_found);
     });
     server.listen(port);
     server.start_accept();
+    sbash64::budget::scheduleEviction(server, tenants);
+    sbash64::budget::scheduleAssetRefresh(server, assets);
     std::cout << "Listening on port " << port << "..." << '\n';
-    server.run();
+    std::vector<std::thread> ioThreads;
+    for (auto i{1U}; i < std::thread::hardware_concurrency(); ++i)
+      ioThreads.emplace_back([&server] { sbash64::budget::run(server); });
+    sbash64::budget::run(server);
+    for (auto &thread : ioThreads)
+      thread.join();
   } catch (websocketpp::exception const &e) {
     std::cout << e.what() << '\n';
   } catch (const std::exception &e) {
@@ -23,10 +23,15 @@ interface OutgoingMessage {
   amount?: string;
   description?: string;
   date?: string;
+  id?: number;
 }
 
-function sendMessage(websocket: WebSocket, message: OutgoingMessage) {
-  websocket.send(JSON.stringify(message));
+interface Server {
+  send(data: string): void;
+}
+
+function sendMessage(server: Server, message: OutgoingMessage) {
+  server.send(JSON.stringify(message));
 }
 
 function accountName(selectedAccountSummaryRow: HTMLTableRowElement): string {
@@ -41,9 +46,7 @@ function transactionMessage(
   return {
     method,
     name: accountName(selectedAccountSummaryRow),
-    description: selectedTransactionRow.cells[1].textContent || "",
-    amount: selectedTransactionRow.cells[2].textContent || "",
-    date: selectedTransactionRow.cells[3].textContent || "",
+    id: Number(selectedTransactionRow.dataset.transactionId),
   };
 }
 
@@ -53,6 +56,176 @@ interface IncomingMessage {
   date: string;
   accountIndex: number;
   transactionIndex: number;
+  transactionId: number;
+  newIndex: number;
+  newAccountIndex: number;
+}
+
+const textDecoder = new TextDecoder();
+
+// Reads the subset of MessagePack written by MessagePackView.
+class MessagePackReader {
+  private readonly data: DataView;
+  private offset = 0;
+
+  constructor(data: DataView) {
+    this.data = data;
+  }
+
+  read(): any {
+    const marker = this.data.getUint8(this.advance(1));
+    if (marker < 0x80) return marker;
+    if (marker >= 0xe0) return marker - 0x100;
+    if ((marker & 0xf0) === 0x90) return this.array(marker & 0x0f);
+    if ((marker & 0xe0) === 0xa0) return this.string(marker & 0x1f);
+    switch (marker) {
+      case 0xc0:
+        return null;
+      case 0xc2:
+        return false;
+      case 0xc3:
+        return true;
+      case 0xcc:
+        return this.data.getUint8(this.advance(1));
+      case 0xcd:
+        return this.data.getUint16(this.advance(2));
+      case 0xce:
+        return this.data.getUint32(this.advance(4));
+      case 0xcf:
+        return Number(this.data.getBigUint64(this.advance(8)));
+      case 0xd0:
+        return this.data.getInt8(this.advance(1));
+      case 0xd1:
+        return this.data.getInt16(this.advance(2));
+      case 0xd2:
+        return this.data.getInt32(this.advance(4));
+      case 0xd3:
+        return Number(this.data.getBigInt64(this.advance(8)));
+      case 0xd9:
+        return this.string(this.data.getUint8(this.advance(1)));
+      case 0xda:
+        return this.string(this.data.getUint16(this.advance(2)));
+      case 0xdb:
+        return this.string(this.data.getUint32(this.advance(4)));
+      case 0xdc:
+        return this.array(this.data.getUint16(this.advance(2)));
+      case 0xdd:
+        return this.array(this.data.getUint32(this.advance(4)));
+      default:
+        throw new Error(`unsupported MessagePack marker ${marker}`);
+    }
+  }
+
+  private advance(length: number): number {
+    const offset = this.offset;
+    this.offset += length;
+    return offset;
+  }
+
+  private array(length: number): any[] {
+    const elements = [];
+    for (let i = 0; i < length; ++i) elements.push(this.read());
+    return elements;
+  }
+
+  private string(length: number): string {
+    return textDecoder.decode(
+      new Uint8Array(
+        this.data.buffer,
+        this.data.byteOffset + this.advance(length),
+        length,
+      ),
+    );
+  }
+}
+
+// Indexed by MessagePackMethod in lib/include/sbash64/budget/protocol.hpp.
+const messagePackMethods = [
+  "update net income",
+  "add account table",
+  "delete account table",
+  "update account name",
+  "update account allocation",
+  "update account balance",
+  "add transaction row",
+  "delete transaction row",
+  "check transaction row",
+  "remove transaction row selection",
+  "mark as saved",
+  "mark as unsaved",
+  "reorder account",
+  "update transaction row",
+  "move transaction row",
+];
+
+function formatAmount(cents: number): string {
+  const magnitude = Math.abs(cents);
+  const fraction = (magnitude % 100).toString().padStart(2, "0");
+  return `${cents < 0 ? "-" : ""}${Math.floor(magnitude / 100)}.${fraction}`;
+}
+
+function formatDate(packed: number): string {
+  const month = (Math.floor(packed / 100) % 100).toString().padStart(2, "0");
+  const day = (packed % 100).toString().padStart(2, "0");
+  return `${month}/${day}/${Math.floor(packed / 10000)}`;
+}
+
+// Converts a packed message into the shape of its JSON counterpart.
+function unpackMessage(packed: any[]): any {
+  const method = messagePackMethods[packed[0]];
+  switch (method) {
+    case "update net income":
+      return { method, amount: formatAmount(packed[1]) };
+    case "add account table":
+      return { method, name: packed[1], accountIndex: packed[2] };
+    case "delete account table":
+      return { method, accountIndex: packed[1] };
+    case "update account name":
+      return { method, accountIndex: packed[1], name: packed[2] };
+    case "update account allocation":
+    case "update account balance":
+      return {
+        method,
+        accountIndex: packed[1],
+        amount: formatAmount(packed[2]),
+      };
+    case "add transaction row":
+      return {
+        method,
+        accountIndex: packed[1],
+        transactionIndex: packed[2],
+        description: packed[3],
+        amount: formatAmount(packed[4]),
+        date: formatDate(packed[5]),
+        transactionId: packed[6],
+      };
+    case "delete transaction row":
+    case "check transaction row":
+    case "remove transaction row selection":
+      return { method, accountIndex: packed[1], transactionIndex: packed[2] };
+    case "reorder account":
+      return { method, accountIndex: packed[1], newIndex: packed[2] };
+    case "update transaction row":
+      return {
+        method,
+        accountIndex: packed[1],
+        transactionIndex: packed[2],
+        newIndex: packed[3],
+        description: packed[4],
+        amount: formatAmount(packed[5]),
+        date: formatDate(packed[6]),
+      };
+    case "move transaction row":
+      return {
+        method,
+        accountIndex: packed[1],
+        transactionIndex: packed[2],
+        newAccountIndex: packed[3],
+        newIndex: packed[4],
+      };
+    default:
+      return { method };
+  }
 }
 
 function updateTransaction(row: HTMLTableRowElement, message: IncomingMessage) {
@@ -86,7 +259,7 @@ function accountSummaryRow(
 
 function sendOnClick(
   button: HTMLElement,
-  websocket: WebSocket,
+  server: Server,
   messageFunctor: () => OutgoingMessage,
   sendFilter: () => boolean = function () {
     return true;
@@ -94,7 +267,7 @@ function sendOnClick(
 ) {
   button.addEventListener("click", () => {
     if (sendFilter()) {
-      sendMessage(websocket, messageFunctor());
+      sendMessage(server, messageFunctor());
     }
   });
 }
@@ -175,6 +348,10 @@ function main() {
   const verifyTransactionButton = document.createElement("button");
   adoptChild(rightHandTableViewButtons, verifyTransactionButton);
   verifyTransactionButton.textContent = "verify";
+  const moveTransactionButton = document.createElement("button");
+  adoptChild(rightHandTableViewButtons, moveTransactionButton);
+  moveTransactionButton.textContent = "move";
+  moveTransactionButton.title = "Move to the Account Named Below";
 
   const accountSummaryTable = document.createElement("table");
   adoptChild(leftHandContent, accountSummaryTable);
@@ -323,7 +500,15 @@ function main() {
   addTransactionButton.type = "submit";
   addTransactionButton.value = "Add";
   addTransactionButton.title = "Add New Transaction";
-  adoptChild(addTransactionForm, divWrapped(addTransactionButton));
+  addTransactionButton.name = "add transaction";
+  const updateTransactionButton = document.createElement("input");
+  updateTransactionButton.type = "submit";
+  updateTransactionButton.value = "Update";
+  updateTransactionButton.title = "Update Selected Transaction";
+  updateTransactionButton.name = "update transaction";
+  const addOrUpdateTransactionButtons = divWrapped(addTransactionButton);
+  adoptChild(addOrUpdateTransactionButtons, updateTransactionButton);
+  adoptChild(addTransactionForm, addOrUpdateTransactionButtons);
 
   let selectedAccountTransactionTableBody: HTMLTableSectionElement | null =
     null;
@@ -341,9 +526,59 @@ function main() {
     };
   }
 
-  const websocket = new WebSocket(`ws://${window.location.host}`);
-  websocket.onmessage = (event) => {
-    const message = JSON.parse(event.data);
+  function reset() {
+    while (accountSummaryTableBody.rows.length > 0)
+      accountSummaryTableBody.deleteRow(0);
+    for (const body of accountTableBodies.splice(0)) body.remove();
+    selectedAccountTransactionTableBody = null;
+    selectedTransactionRow = null;
+    selectedAccountSummaryRow = null;
+    rightHandTableTitle.textContent = "";
+  }
+
+  // The sequence of the last frame applied, which a reconnection resumes
+  // after.
+  let lastSequence: number | null = null;
+  function applyFrame(sequence: number, snapshot: boolean, messages: any[]) {
+    if (snapshot) reset();
+    for (const message of messages) handleMessage(message);
+    lastSequence = sequence;
+  }
+
+  function connect(): WebSocket {
+    const resume = lastSequence === null ? "" : `?resume=${lastSequence}`;
+    const socket = new WebSocket(
+      `ws://${window.location.host}${window.location.pathname}${resume}`,
+      new URLSearchParams(window.location.search).has("json")
+        ? ["sbash64-budget.json"]
+        : ["sbash64-budget.msgpack", "sbash64-budget.json"],
+    );
+    socket.binaryType = "arraybuffer";
+    socket.onmessage = (event) => {
+      if (typeof event.data !== "string") {
+        const [sequence, snapshot, packed] = new MessagePackReader(
+          new DataView(event.data),
+        ).read();
+        applyFrame(sequence, snapshot, packed.map(unpackMessage));
+        return;
+      }
+      const frame = JSON.parse(event.data);
+      applyFrame(frame.sequence, frame.snapshot, frame.messages);
+    };
+    socket.onclose = () => {
+      setTimeout(() => {
+        websocket = connect();
+      }, 1000);
+    };
+    return socket;
+  }
+  let websocket = connect();
+  const server: Server = {
+    send(data: string) {
+      if (websocket.readyState === WebSocket.OPEN) websocket.send(data);
+    },
+  };
+  function handleMessage(message: any) {
     switch (message.method) {
       case "reorder account": {
         const row = accountSummaryTableBody.rows[message.accountIndex];
@@ -421,6 +656,7 @@ function main() {
         createChild(row, "td").style.textAlign = "center";
         createChild(row, "td").style.textAlign = "center";
         row.onclick = transactionRowSelectionHandler(row);
+        row.dataset.transactionId = String(message.transactionId);
         updateTransaction(row, message);
         break;
       }
@@ -429,6 +665,27 @@ function main() {
           message.transactionIndex,
         );
         break;
+      case "update transaction row": {
+        const row = transactionRow(accountTableBodies, message);
+        if (message.newIndex !== message.transactionIndex) {
+          const parent = accountTableBody(accountTableBodies, message);
+          parent.removeChild(row);
+          parent.insertBefore(row, parent.rows[message.newIndex] ?? null);
+        }
+        updateTransaction(row, message);
+        break;
+      }
+      case "move transaction row": {
+        const row = transactionRow(accountTableBodies, message);
+        if (row === selectedTransactionRow) {
+          row.style.backgroundColor = "";
+          selectedTransactionRow = null;
+        }
+        row.remove();
+        const body = accountTableBodies[message.newAccountIndex];
+        body.insertBefore(row, body.rows[message.newIndex] ?? null);
+        break;
+      }
       case "update account balance":
         accountSummaryRow(
           accountSummaryTableBody,
@@ -459,19 +716,19 @@ function main() {
       default:
         break;
     }
-  };
-  sendOnClick(saveButton, websocket, () => ({
+  }
+  sendOnClick(saveButton, server, () => ({
     method: "save",
   }));
-  sendOnClick(reduceButton, websocket, () => ({
+  sendOnClick(reduceButton, server, () => ({
     method: "reduce",
   }));
-  sendOnClick(restoreButton, websocket, () => ({
+  sendOnClick(restoreButton, server, () => ({
     method: "restore",
   }));
   sendOnClick(
     removeAccountButton,
-    websocket,
+    server,
     () => ({
       method: "remove account",
       name: accountName(selectedAccountSummaryRow!),
@@ -482,7 +739,7 @@ function main() {
   );
   sendOnClick(
     closeAccountButton,
-    websocket,
+    server,
     () => ({
       method: "close account",
       name: accountName(selectedAccountSummaryRow!),
@@ -493,7 +750,7 @@ function main() {
   );
   sendOnClick(
     removeTransactionButton,
-    websocket,
+    server,
     () =>
       transactionMessage(
         selectedAccountSummaryRow!,
@@ -508,7 +765,7 @@ function main() {
   );
   sendOnClick(
     verifyTransactionButton,
-    websocket,
+    server,
     () =>
       transactionMessage(
         selectedAccountSummaryRow!,
@@ -521,10 +778,29 @@ function main() {
       );
     },
   );
+  sendOnClick(
+    moveTransactionButton,
+    server,
+    () => ({
+      ...transactionMessage(
+        selectedAccountSummaryRow!,
+        selectedTransactionRow!,
+        "move transaction",
+      ),
+      newName: newAccountNameInput.value,
+    }),
+    () => {
+      return (
+        selectedAccountSummaryRow !== null &&
+        selectedTransactionRow !== null &&
+        newAccountNameInput.value !== ""
+      );
+    },
+  );
   createOrRenameAccountForm.addEventListener("submit", (event) => {
     event.preventDefault();
 
-    sendMessage(websocket, {
+    sendMessage(server, {
       method: `${(event.submitter as HTMLInputElement).name} account`,
       name:
         selectedAccountSummaryRow !== null
@@ -538,7 +814,7 @@ function main() {
     event.preventDefault();
 
     if (selectedAccountSummaryRow !== null) {
-      sendMessage(websocket, {
+      sendMessage(server, {
         method: (event.submitter as HTMLInputElement).name,
         name: accountName(selectedAccountSummaryRow),
         amount: transferAndAllocateInput.value,
@@ -549,10 +825,18 @@ function main() {
   addTransactionForm.addEventListener("submit", (event) => {
     event.preventDefault();
 
-    if (selectedAccountSummaryRow !== null) {
-      sendMessage(websocket, {
-        method: "add transaction",
+    const method = (event.submitter as HTMLInputElement).name;
+    const updating = method === "update transaction";
+    if (
+      selectedAccountSummaryRow !== null &&
+      (!updating || selectedTransactionRow !== null)
+    ) {
+      sendMessage(server, {
+        method,
         name: accountName(selectedAccountSummaryRow),
+        id: updating
+          ? Number(selectedTransactionRow!.dataset.transactionId)
+          : undefined,
         description: addTransactionDescriptionInput.value,
         amount: addTransactionAmountInput.value,
         date: addTransactionDateInput.value,